@@ -0,0 +1,3620 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h> // For memcpy, memset
+#include <limits.h> // For INT_MIN, INT_MAX
+#include <stdint.h> // For fixed-width arithmetic (NTT, division by machine integers)
+#include <stdatomic.h> // Tuning knobs and kernel choice are shared by all threads
+
+#include "bcd.h"
+
+// SIMD kernels with runtime CPU dispatch (GCC/Clang on x86 only)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BCD_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+// Thread-exit cleanup of the per-thread caches (POSIX threads)
+#if defined(__unix__) || defined(__APPLE__)
+#define BCD_THREAD_EXIT_HOOK
+#include <pthread.h>
+#endif
+
+// --- Function Implementations ---
+
+// --- Thread-local allocation pool ---
+// Bitset headers and data buffers of up to 2^(BCD_POOL_CLASSES-1) words are recycled through
+// per-thread free lists, one per power-of-two word count, so short-lived numbers mostly skip
+// malloc/free. Larger buffers go straight to the heap. Build with BCD_NO_POOL to bypass the
+// pool (e.g. for leak checkers); the counters then only record misses.
+#define BCD_POOL_MAX_CACHED 256 // Per class; frees beyond this go back to the heap
+
+typedef struct
+{
+    unsigned long *free_words[BCD_POOL_CLASSES]; // Intrusive lists, next pointer in word 0
+    size_t cached_words[BCD_POOL_CLASSES];
+    Bitset *free_headers;                        // Linked through Bitset::data
+    size_t cached_headers;
+    BcdPoolStats stats;
+} BcdPool;
+
+static _Thread_local BcdPool bcd_pool;
+
+// Scratch arena shared by the calling thread's operations that are not given one
+static _Thread_local BcdArena *bcd_thread_arena;
+
+#ifdef BCD_THREAD_EXIT_HOOK
+// A thread that caches anything sets a key whose destructor runs bcd_pool_trim when it exits
+static pthread_key_t bcd_pool_exit_key;
+static pthread_once_t bcd_pool_exit_once = PTHREAD_ONCE_INIT;
+static bool bcd_pool_exit_key_ok;
+static _Thread_local bool bcd_pool_exit_armed;
+
+static void bcd_pool_thread_exit(void *unused)
+{
+    (void)unused;
+    bcd_pool_exit_armed = false;
+    bcd_pool_trim();
+}
+
+static void bcd_pool_create_exit_key(void)
+{
+    bcd_pool_exit_key_ok = pthread_key_create(&bcd_pool_exit_key, bcd_pool_thread_exit) == 0;
+}
+
+static void bcd_pool_arm_thread_exit(void)
+{
+    if (bcd_pool_exit_armed) return;
+    pthread_once(&bcd_pool_exit_once, bcd_pool_create_exit_key);
+    if (bcd_pool_exit_key_ok) pthread_setspecific(bcd_pool_exit_key, &bcd_pool);
+    bcd_pool_exit_armed = true;
+}
+#else
+static void bcd_pool_arm_thread_exit(void) {}
+#endif
+
+// Size class of a buffer of `words` words, or BCD_POOL_CLASSES when it is not pooled
+static unsigned bcd_pool_class(size_t words)
+{
+    unsigned c = 0;
+    while (c < BCD_POOL_CLASSES && ((size_t)1 << c) < words) c++;
+    return c;
+}
+
+/**
+ * @brief Returns a zeroed buffer of at least *words words and stores the actual word count
+ * (the class size for pooled buffers) back in *words.
+ */
+static unsigned long *bcd_pool_alloc_words(size_t *words)
+{
+    unsigned c = bcd_pool_class(*words);
+    if (c == BCD_POOL_CLASSES) {
+        bcd_pool.stats.oversize++;
+        return (unsigned long *)calloc(*words, sizeof(unsigned long));
+    }
+    *words = (size_t)1 << c;
+#ifndef BCD_NO_POOL
+    unsigned long *p = bcd_pool.free_words[c];
+    if (p) {
+        bcd_pool.free_words[c] = (unsigned long *)p[0];
+        bcd_pool.cached_words[c]--;
+        bcd_pool.stats.data_hits[c]++;
+        memset(p, 0, *words * sizeof(unsigned long));
+        return p;
+    }
+#endif
+    bcd_pool.stats.data_misses[c]++;
+    return (unsigned long *)calloc(*words, sizeof(unsigned long));
+}
+
+static void bcd_pool_free_words(unsigned long *p, size_t words)
+{
+    if (!p) return;
+#ifndef BCD_NO_POOL
+    unsigned c = bcd_pool_class(words);
+    if (c < BCD_POOL_CLASSES && ((size_t)1 << c) == words && bcd_pool.cached_words[c] < BCD_POOL_MAX_CACHED) {
+        bcd_pool_arm_thread_exit();
+        p[0] = (unsigned long)bcd_pool.free_words[c];
+        bcd_pool.free_words[c] = p;
+        bcd_pool.cached_words[c]++;
+        return;
+    }
+#else
+    (void)words;
+#endif
+    free(p);
+}
+
+// Grows a buffer from old_words to at least *words words (zero-filled), like realloc
+static unsigned long *bcd_pool_realloc_words(unsigned long *p, size_t old_words, size_t *words)
+{
+    if (bcd_pool_class(old_words) == BCD_POOL_CLASSES && bcd_pool_class(*words) == BCD_POOL_CLASSES) {
+        unsigned long *grown = (unsigned long *)realloc(p, *words * sizeof(unsigned long));
+        if (grown) memset(grown + old_words, 0, (*words - old_words) * sizeof(unsigned long));
+        bcd_pool.stats.oversize++;
+        return grown;
+    }
+    unsigned long *grown = bcd_pool_alloc_words(words);
+    if (!grown) return NULL;
+    memcpy(grown, p, old_words * sizeof(unsigned long));
+    bcd_pool_free_words(p, old_words);
+    return grown;
+}
+
+static Bitset *bcd_pool_alloc_header(void)
+{
+#ifndef BCD_NO_POOL
+    Bitset *bitset = bcd_pool.free_headers;
+    if (bitset) {
+        bcd_pool.free_headers = (Bitset *)bitset->data;
+        bcd_pool.cached_headers--;
+        bcd_pool.stats.header_hits++;
+        return bitset;
+    }
+#endif
+    bcd_pool.stats.header_misses++;
+    return (Bitset *)malloc(sizeof(Bitset));
+}
+
+static void bcd_pool_free_header(Bitset *bitset)
+{
+#ifndef BCD_NO_POOL
+    if (bcd_pool.cached_headers < BCD_POOL_MAX_CACHED) {
+        bcd_pool_arm_thread_exit();
+        bitset->data = (unsigned long *)bcd_pool.free_headers;
+        bcd_pool.free_headers = bitset;
+        bcd_pool.cached_headers++;
+        return;
+    }
+#endif
+    free(bitset);
+}
+
+// Counters of the calling thread since it started or since the last bcd_pool_reset_stats
+void bcd_pool_get_stats(BcdPoolStats *stats)
+{
+    if (stats) *stats = bcd_pool.stats;
+}
+
+void bcd_pool_reset_stats(void)
+{
+    memset(&bcd_pool.stats, 0, sizeof(bcd_pool.stats));
+}
+
+// Returns every block cached by the calling thread to the heap, scratch arena included
+// (runs automatically when a POSIX thread exits; elsewhere call it before a thread exits)
+void bcd_pool_trim(void)
+{
+    for (unsigned c = 0; c < BCD_POOL_CLASSES; c++) {
+        while (bcd_pool.free_words[c]) {
+            unsigned long *p = bcd_pool.free_words[c];
+            bcd_pool.free_words[c] = (unsigned long *)p[0];
+            free(p);
+        }
+        bcd_pool.cached_words[c] = 0;
+    }
+    while (bcd_pool.free_headers) {
+        Bitset *bitset = bcd_pool.free_headers;
+        bcd_pool.free_headers = (Bitset *)bitset->data;
+        free(bitset);
+    }
+    bcd_pool.cached_headers = 0;
+    bcd_arena_destroy(bcd_thread_arena);
+    bcd_thread_arena = NULL;
+}
+
+/**
+ * @brief Initializes a zero Bitset of size bits in storage the caller owns (a local, an array
+ * element, a field). Values up to BITSET_INLINE_WORDS words live in the struct; larger ones
+ * get a pooled buffer. Release with bitset_destroy. Returns false on allocation failure.
+ */
+bool bitset_init(Bitset *bitset, size_t size)
+{
+    if (!bitset) return false;
+    bitset->size = size;
+    bitset->is_negative = false;
+    bitset->digits = BITSET_DIGITS_UNKNOWN; // Callers fill data directly after create
+    size_t num_words = (size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    if (num_words <= BITSET_INLINE_WORDS) {
+        memset(bitset->inline_words, 0, sizeof(bitset->inline_words));
+        bitset->data = bitset->inline_words;
+        num_words = BITSET_INLINE_WORDS;
+    } else {
+        bitset->data = bcd_pool_alloc_words(&num_words); // Rounded up to the size class
+        if (!bitset->data) {
+            fprintf(stderr,"Error: calloc failed for Bitset data (size %zu)\n", size);
+            return false;
+        }
+    }
+    bitset->capacity = num_words * BITSET_WORD_SIZE;
+    return true;
+}
+
+void bitset_destroy(Bitset *bitset)
+{
+    if (!bitset) return;
+    if (bitset->data != bitset->inline_words) {
+        bcd_pool_free_words(bitset->data, bitset->capacity / BITSET_WORD_SIZE);
+    }
+    bitset->data = bitset->inline_words;
+    bitset->size = 0;
+    bitset->capacity = 0;
+    bitset->digits = 0;
+}
+
+Bitset *bitset_create(size_t size)
+{
+    Bitset *bitset = bcd_pool_alloc_header();
+    if (!bitset) { fprintf(stderr,"Error: malloc failed for Bitset struct\n"); return NULL; }
+    if (!bitset_init(bitset, size)) {
+        bcd_pool_free_header(bitset);
+        return NULL;
+    }
+    return bitset;
+}
+
+void bitset_free(Bitset *bitset)
+{
+    if (bitset != NULL)
+    {
+        bitset_destroy(bitset);
+        bcd_pool_free_header(bitset);
+    }
+}
+
+// Creates a new copy of a bitset
+Bitset *bitset_copy(const Bitset *original) {
+    if (!original) return NULL;
+    Bitset *copy = bitset_create(original->size);
+    if (!copy) return NULL; // Allocation failed
+    copy->is_negative = original->is_negative;
+    size_t num_words = (original->size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    if (original->data && copy->data) { // Check if data pointers are valid
+        memcpy(copy->data, original->data, num_words * sizeof(unsigned long));
+        copy->digits = bitset_digit_length(original); // Atomic read; the source may be shared
+    } else if (original->size > 0) {
+        // This case shouldn't happen if create is correct, but handle defensively
+        fprintf(stderr, "Warning: Copying bitset with NULL data pointer but size > 0.\n");
+        // Data in copy is already zeroed by calloc in bitset_create
+    }
+    return copy;
+}
+
+
+void bitset_set(Bitset *bitset, size_t index, bool value)
+{
+    if (!bitset || !bitset->data || index >= bitset->size) // Added check for bitset->data
+        return;
+    size_t word_index = index / BITSET_WORD_SIZE;
+    size_t bit_index = index % BITSET_WORD_SIZE;
+    bitset->digits = BITSET_DIGITS_UNKNOWN;
+    if (value)
+        bitset->data[word_index] |= (1UL << bit_index);
+    else
+        bitset->data[word_index] &= ~(1UL << bit_index);
+}
+
+
+bool bitset_test(const Bitset *bitset, size_t index)
+{
+    if (!bitset || !bitset->data || index >= bitset->size) // Added check for bitset->data
+        return false;
+    size_t word_index = index / BITSET_WORD_SIZE;
+    size_t bit_index = index % BITSET_WORD_SIZE;
+    return (bitset->data[word_index] & (1UL << bit_index)) != 0;
+}
+
+Bitset *bitset_resize(const Bitset *bitset, size_t new_size, bool keep_sign)
+{
+    // Handle case where original is NULL
+    if (!bitset) {
+        Bitset* new_bs = bitset_create(new_size);
+        // Sign defaults to false, which is fine if original was NULL (conceptually zero)
+        return new_bs;
+    }
+
+    Bitset *resized = bitset_create(new_size);
+    if (!resized) return NULL; // Allocation failed
+
+    if (keep_sign) {
+        resized->is_negative = bitset->is_negative;
+    } // else it defaults to false
+
+    // Copy bits efficiently using memcpy
+    size_t min_size = (bitset->size < new_size) ? bitset->size : new_size;
+    if (min_size > 0 && bitset->data && resized->data) {
+        size_t words_to_copy = (min_size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+        memcpy(resized->data, bitset->data, words_to_copy * sizeof(unsigned long));
+
+        // Mask any extra bits in the last copied word if sizes aren't word-aligned
+        if (min_size % BITSET_WORD_SIZE != 0 && words_to_copy > 0) {
+            size_t bits_in_last_word = min_size % BITSET_WORD_SIZE;
+            unsigned long mask = (1UL << bits_in_last_word) - 1;
+            resized->data[words_to_copy - 1] &= mask;
+        }
+    }
+    // If new_size > bitset->size, the extra bits/words are already zero from calloc
+
+    return resized;
+}
+
+/**
+ * @brief Makes room for at least `bits` bits without changing size or value.
+ * Capacity at least doubles on each reallocation, so repeated growth is amortized O(1).
+ */
+bool bitset_reserve(Bitset *bitset, size_t bits)
+{
+    if (!bitset) return false;
+    if (bits <= bitset->capacity) return true;
+    size_t old_words = bitset->capacity / BITSET_WORD_SIZE;
+    size_t new_words = (bits + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    if (new_words < 2 * old_words) new_words = 2 * old_words;
+    unsigned long *grown;
+    if (bitset->data == bitset->inline_words) { // Spill to the heap
+        grown = bcd_pool_alloc_words(&new_words);
+        if (grown) memcpy(grown, bitset->inline_words, old_words * sizeof(unsigned long));
+    } else {
+        grown = bcd_pool_realloc_words(bitset->data, old_words, &new_words);
+    }
+    if (!grown) { fprintf(stderr, "Error: realloc failed for Bitset data (%zu bits)\n", bits); return false; }
+    bitset->data = grown;
+    bitset->capacity = new_words * BITSET_WORD_SIZE;
+    return true;
+}
+
+/**
+ * @brief Changes size in place, keeping the low min(old, new) bits. Shrinking only clears
+ * the dropped bits; growing reallocates only when the new size exceeds capacity.
+ */
+bool bitset_resize_in_place(Bitset *bitset, size_t new_size)
+{
+    if (!bitset) return false;
+    if (new_size > bitset->size) {
+        if (!bitset_reserve(bitset, new_size)) return false;
+    } else if (new_size < bitset->size) {
+        size_t keep_words = (new_size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+        size_t old_words = (bitset->size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+        if (new_size % BITSET_WORD_SIZE != 0)
+            bitset->data[keep_words - 1] &= (1UL << (new_size % BITSET_WORD_SIZE)) - 1;
+        memset(bitset->data + keep_words, 0, (old_words - keep_words) * sizeof(unsigned long));
+        bitset->digits = BITSET_DIGITS_UNKNOWN;
+    }
+    bitset->size = new_size;
+    return true;
+}
+
+// --- Word-parallel (SWAR) BCD kernels ---
+// A word of Bitset::data holds BCD_DIGITS_PER_WORD packed digits, LSB digit in the low nibble.
+#define BCD_DIGITS_PER_WORD (BITSET_WORD_SIZE / 4)
+#define BCD_NIBBLE_ONES (~0UL / 0xFUL)            // 0x1111...1 for any word width
+#define BCD_NIBBLE_SIXES (BCD_NIBBLE_ONES * 6UL)  // 0x6666...6
+#define BCD_TOP_NIBBLE_SIX (6UL << (BITSET_WORD_SIZE - 4))
+
+/**
+ * @brief Adds two words of packed BCD digits plus a carry-in (0 or 1).
+ * Every digit is pre-biased by 6 so decimal carries show up as binary carries;
+ * digits that did not carry get the 6 taken back out. *carry receives the carry-out.
+ */
+static unsigned long bcd_word_add(unsigned long a, unsigned long b, unsigned long *carry)
+{
+    unsigned long biased = a + BCD_NIBBLE_SIXES; // Cannot overflow for valid BCD
+    unsigned long sum = biased + b;
+    unsigned long carry_out = (sum < biased);
+    unsigned long total = sum + *carry;
+    carry_out |= (total < sum);
+
+    // Bit 4k of (total ^ biased ^ b) is the carry out of digit k-1
+    unsigned long no_carry = ~(total ^ biased ^ b) & (BCD_NIBBLE_ONES & ~1UL);
+    unsigned long correction = (no_carry >> 2) | (no_carry >> 3); // 0110 under each digit that did not carry
+    if (!carry_out) correction |= BCD_TOP_NIBBLE_SIX;
+
+    *carry = carry_out;
+    return total - correction;
+}
+
+/**
+ * @brief Subtracts two words of packed BCD digits and a borrow-in (0 or 1).
+ * Digits that borrowed wrapped to (difference + 16); taking 6 off gives (difference + 10).
+ * *borrow receives the borrow-out.
+ */
+static unsigned long bcd_word_sub(unsigned long a, unsigned long b, unsigned long *borrow)
+{
+    unsigned long diff = a - b;
+    unsigned long borrow_out = (a < b);
+    unsigned long total = diff - *borrow;
+    borrow_out |= (diff < *borrow);
+
+    // Bit 4k of (total ^ a ^ b) is the borrow out of digit k-1
+    unsigned long borrowed = (total ^ a ^ b) & (BCD_NIBBLE_ONES & ~1UL);
+    unsigned long correction = (borrowed >> 2) | (borrowed >> 3);
+    if (borrow_out) correction |= BCD_TOP_NIBBLE_SIX;
+
+    *borrow = borrow_out;
+    return total - correction;
+}
+
+/**
+ * @brief w * digit + *carry for one word, digit and *carry at most 9.
+ * Sums the doublings w, 2w, 4w, 8w selected by digit's bits with word adds; the digit that
+ * spills past the word accumulates as a plain integer and is returned in *carry.
+ */
+static unsigned long bcd_word_mul_digit(unsigned long w, unsigned digit, unsigned long *carry)
+{
+    unsigned long product = 0, spill = 0;
+    unsigned long power = w, power_spill = 0; // w * 2^k
+    for (;;) {
+        unsigned long c = 0;
+        if (digit & 1u) {
+            product = bcd_word_add(product, power, &c);
+            spill += power_spill + c;
+        }
+        digit >>= 1;
+        if (!digit) break;
+        c = 0;
+        power = bcd_word_add(power, power, &c);
+        power_spill = 2 * power_spill + c;
+    }
+    unsigned long c = 0;
+    product = bcd_word_add(product, *carry, &c);
+    *carry = spill + c;
+    return product;
+}
+
+// Nines complement of one word: no digit borrows because every digit is <= 9
+#define BCD_NIBBLE_NINES (BCD_NIBBLE_ONES * 9UL)  // 0x9999...9
+
+/**
+ * @brief Writes the 9's complement of the low size_bits bits of src into dst.
+ * Bits of dst above size_bits are left zero.
+ */
+static void bcd_nines_complement(unsigned long *dst, const unsigned long *src, size_t size_bits)
+{
+    size_t num_words = (size_bits + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    for (size_t w = 0; w < num_words; w++) {
+        dst[w] = BCD_NIBBLE_NINES - src[w];
+    }
+    if (size_bits % BITSET_WORD_SIZE != 0) {
+        dst[num_words - 1] &= (1UL << (size_bits % BITSET_WORD_SIZE)) - 1;
+    }
+}
+
+// --- Array kernels (r = a +/- b +/- carry over n words, return carry/borrow out) ---
+typedef unsigned long (*BcdWordKernel)(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                                      size_t n, unsigned long carry);
+
+static unsigned long bcd_add_n_scalar(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                                      size_t n, unsigned long carry)
+{
+    for (size_t w = 0; w < n; w++) {
+        r[w] = bcd_word_add(a[w], b[w], &carry);
+    }
+    return carry;
+}
+
+static unsigned long bcd_sub_n_scalar(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                                      size_t n, unsigned long borrow)
+{
+    for (size_t w = 0; w < n; w++) {
+        r[w] = bcd_word_sub(a[w], b[w], &borrow);
+    }
+    return borrow;
+}
+
+#ifdef BCD_X86_DISPATCH
+/*
+ * SIMD kernels work on 64-bit lanes straight from memory, so they are independent of
+ * sizeof(unsigned long). Each lane is added twice (carry-in 0 and carry-in 1); the lane
+ * carry-ins are then resolved with a parallel-prefix step on the per-lane generate /
+ * propagate masks, which is just a binary add of the two masks.
+ */
+#define BCD_LANE_SIXES 0x6666666666666666LL
+#define BCD_LANE_BOUNDARY 0x1111111111111110LL
+#define BCD_LANE_TOP_SIX 0x6000000000000000LL
+#define BCD_LANE_SIGN ((long long)0x8000000000000000ULL)
+
+__attribute__((target("avx2")))
+static unsigned long bcd_add_n_avx2(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                                    size_t n, unsigned long carry)
+{
+    const size_t words_per_block = 32 / sizeof(unsigned long);
+    const __m256i sixes = _mm256_set1_epi64x(BCD_LANE_SIXES);
+    const __m256i boundary = _mm256_set1_epi64x(BCD_LANE_BOUNDARY);
+    const __m256i top_six = _mm256_set1_epi64x(BCD_LANE_TOP_SIX);
+    const __m256i sign = _mm256_set1_epi64x(BCD_LANE_SIGN);
+    const __m256i ones = _mm256_set1_epi64x(1);
+    const __m256i lane_bits = _mm256_setr_epi64x(1, 2, 4, 8);
+    size_t w = 0;
+
+    for (; w + words_per_block <= n; w += words_per_block) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + w));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + w));
+        __m256i biased = _mm256_add_epi64(va, sixes);
+        __m256i sum0 = _mm256_add_epi64(biased, vb);   // Lane result for carry-in 0
+        __m256i sum1 = _mm256_add_epi64(sum0, ones);   // Lane result for carry-in 1
+
+        // Unsigned lane overflow via signed compares on sign-flipped values
+        __m256i biased_s = _mm256_xor_si256(biased, sign);
+        __m256i carry0 = _mm256_cmpgt_epi64(biased_s, _mm256_xor_si256(sum0, sign));
+        __m256i carry1 = _mm256_xor_si256(_mm256_cmpgt_epi64(_mm256_xor_si256(sum1, sign), biased_s),
+                                          _mm256_set1_epi64x(-1));
+
+        unsigned generate = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(carry0));
+        unsigned carries = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(carry1));
+        unsigned prefix = carries + generate + (unsigned)carry;
+        unsigned lane_carry_in = (prefix ^ carries ^ generate) & 0xFu;
+        carry = (prefix >> 4) & 1u;
+
+        __m256i select = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(lane_carry_in), lane_bits), lane_bits);
+        __m256i total = _mm256_blendv_epi8(sum0, sum1, select);
+        __m256i lane_carry_out = _mm256_blendv_epi8(carry0, carry1, select);
+
+        __m256i no_carry = _mm256_andnot_si256(_mm256_xor_si256(_mm256_xor_si256(total, biased), vb), boundary);
+        __m256i correction = _mm256_or_si256(_mm256_srli_epi64(no_carry, 2), _mm256_srli_epi64(no_carry, 3));
+        correction = _mm256_or_si256(correction, _mm256_andnot_si256(lane_carry_out, top_six));
+        _mm256_storeu_si256((__m256i *)(r + w), _mm256_sub_epi64(total, correction));
+    }
+    return bcd_add_n_scalar(r + w, a + w, b + w, n - w, carry);
+}
+
+__attribute__((target("avx2")))
+static unsigned long bcd_sub_n_avx2(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                                    size_t n, unsigned long borrow)
+{
+    const size_t words_per_block = 32 / sizeof(unsigned long);
+    const __m256i boundary = _mm256_set1_epi64x(BCD_LANE_BOUNDARY);
+    const __m256i top_six = _mm256_set1_epi64x(BCD_LANE_TOP_SIX);
+    const __m256i sign = _mm256_set1_epi64x(BCD_LANE_SIGN);
+    const __m256i ones = _mm256_set1_epi64x(1);
+    const __m256i lane_bits = _mm256_setr_epi64x(1, 2, 4, 8);
+    size_t w = 0;
+
+    for (; w + words_per_block <= n; w += words_per_block) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + w));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + w));
+        __m256i diff0 = _mm256_sub_epi64(va, vb);     // Lane result for borrow-in 0
+        __m256i diff1 = _mm256_sub_epi64(diff0, ones); // Lane result for borrow-in 1
+
+        // a < b borrows with borrow-in 0, a <= b with borrow-in 1
+        __m256i va_s = _mm256_xor_si256(va, sign);
+        __m256i vb_s = _mm256_xor_si256(vb, sign);
+        __m256i borrow0 = _mm256_cmpgt_epi64(vb_s, va_s);
+        __m256i borrow1 = _mm256_xor_si256(_mm256_cmpgt_epi64(va_s, vb_s), _mm256_set1_epi64x(-1));
+
+        unsigned generate = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(borrow0));
+        unsigned borrows = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(borrow1));
+        unsigned prefix = borrows + generate + (unsigned)borrow;
+        unsigned lane_borrow_in = (prefix ^ borrows ^ generate) & 0xFu;
+        borrow = (prefix >> 4) & 1u;
+
+        __m256i select = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(lane_borrow_in), lane_bits), lane_bits);
+        __m256i total = _mm256_blendv_epi8(diff0, diff1, select);
+        __m256i lane_borrow_out = _mm256_blendv_epi8(borrow0, borrow1, select);
+
+        __m256i borrowed = _mm256_and_si256(_mm256_xor_si256(_mm256_xor_si256(total, va), vb), boundary);
+        __m256i correction = _mm256_or_si256(_mm256_srli_epi64(borrowed, 2), _mm256_srli_epi64(borrowed, 3));
+        correction = _mm256_or_si256(correction, _mm256_and_si256(lane_borrow_out, top_six));
+        _mm256_storeu_si256((__m256i *)(r + w), _mm256_sub_epi64(total, correction));
+    }
+    return bcd_sub_n_scalar(r + w, a + w, b + w, n - w, borrow);
+}
+
+__attribute__((target("sse4.2")))
+static unsigned long bcd_add_n_sse42(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                                     size_t n, unsigned long carry)
+{
+    const size_t words_per_block = 16 / sizeof(unsigned long);
+    const __m128i sixes = _mm_set1_epi64x(BCD_LANE_SIXES);
+    const __m128i boundary = _mm_set1_epi64x(BCD_LANE_BOUNDARY);
+    const __m128i top_six = _mm_set1_epi64x(BCD_LANE_TOP_SIX);
+    const __m128i sign = _mm_set1_epi64x(BCD_LANE_SIGN);
+    const __m128i ones = _mm_set1_epi64x(1);
+    const __m128i lane_bits = _mm_set_epi64x(2, 1);
+    size_t w = 0;
+
+    for (; w + words_per_block <= n; w += words_per_block) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + w));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + w));
+        __m128i biased = _mm_add_epi64(va, sixes);
+        __m128i sum0 = _mm_add_epi64(biased, vb);
+        __m128i sum1 = _mm_add_epi64(sum0, ones);
+
+        __m128i biased_s = _mm_xor_si128(biased, sign);
+        __m128i carry0 = _mm_cmpgt_epi64(biased_s, _mm_xor_si128(sum0, sign));
+        __m128i carry1 = _mm_xor_si128(_mm_cmpgt_epi64(_mm_xor_si128(sum1, sign), biased_s),
+                                       _mm_set1_epi64x(-1));
+
+        unsigned generate = (unsigned)_mm_movemask_pd(_mm_castsi128_pd(carry0));
+        unsigned carries = (unsigned)_mm_movemask_pd(_mm_castsi128_pd(carry1));
+        unsigned prefix = carries + generate + (unsigned)carry;
+        unsigned lane_carry_in = (prefix ^ carries ^ generate) & 0x3u;
+        carry = (prefix >> 2) & 1u;
+
+        __m128i select = _mm_cmpeq_epi64(_mm_and_si128(_mm_set1_epi64x(lane_carry_in), lane_bits), lane_bits);
+        __m128i total = _mm_blendv_epi8(sum0, sum1, select);
+        __m128i lane_carry_out = _mm_blendv_epi8(carry0, carry1, select);
+
+        __m128i no_carry = _mm_andnot_si128(_mm_xor_si128(_mm_xor_si128(total, biased), vb), boundary);
+        __m128i correction = _mm_or_si128(_mm_srli_epi64(no_carry, 2), _mm_srli_epi64(no_carry, 3));
+        correction = _mm_or_si128(correction, _mm_andnot_si128(lane_carry_out, top_six));
+        _mm_storeu_si128((__m128i *)(r + w), _mm_sub_epi64(total, correction));
+    }
+    return bcd_add_n_scalar(r + w, a + w, b + w, n - w, carry);
+}
+
+__attribute__((target("sse4.2")))
+static unsigned long bcd_sub_n_sse42(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                                     size_t n, unsigned long borrow)
+{
+    const size_t words_per_block = 16 / sizeof(unsigned long);
+    const __m128i boundary = _mm_set1_epi64x(BCD_LANE_BOUNDARY);
+    const __m128i top_six = _mm_set1_epi64x(BCD_LANE_TOP_SIX);
+    const __m128i sign = _mm_set1_epi64x(BCD_LANE_SIGN);
+    const __m128i ones = _mm_set1_epi64x(1);
+    const __m128i lane_bits = _mm_set_epi64x(2, 1);
+    size_t w = 0;
+
+    for (; w + words_per_block <= n; w += words_per_block) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + w));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + w));
+        __m128i diff0 = _mm_sub_epi64(va, vb);
+        __m128i diff1 = _mm_sub_epi64(diff0, ones);
+
+        __m128i va_s = _mm_xor_si128(va, sign);
+        __m128i vb_s = _mm_xor_si128(vb, sign);
+        __m128i borrow0 = _mm_cmpgt_epi64(vb_s, va_s);
+        __m128i borrow1 = _mm_xor_si128(_mm_cmpgt_epi64(va_s, vb_s), _mm_set1_epi64x(-1));
+
+        unsigned generate = (unsigned)_mm_movemask_pd(_mm_castsi128_pd(borrow0));
+        unsigned borrows = (unsigned)_mm_movemask_pd(_mm_castsi128_pd(borrow1));
+        unsigned prefix = borrows + generate + (unsigned)borrow;
+        unsigned lane_borrow_in = (prefix ^ borrows ^ generate) & 0x3u;
+        borrow = (prefix >> 2) & 1u;
+
+        __m128i select = _mm_cmpeq_epi64(_mm_and_si128(_mm_set1_epi64x(lane_borrow_in), lane_bits), lane_bits);
+        __m128i total = _mm_blendv_epi8(diff0, diff1, select);
+        __m128i lane_borrow_out = _mm_blendv_epi8(borrow0, borrow1, select);
+
+        __m128i borrowed = _mm_and_si128(_mm_xor_si128(_mm_xor_si128(total, va), vb), boundary);
+        __m128i correction = _mm_or_si128(_mm_srli_epi64(borrowed, 2), _mm_srli_epi64(borrowed, 3));
+        correction = _mm_or_si128(correction, _mm_and_si128(lane_borrow_out, top_six));
+        _mm_storeu_si128((__m128i *)(r + w), _mm_sub_epi64(total, correction));
+    }
+    return bcd_sub_n_scalar(r + w, a + w, b + w, n - w, borrow);
+}
+#endif
+
+// --- Column kernels (bcd_sum: even/odd += the even/odd digits of x, one digit per byte) ---
+#define BCD_SUM_BYTE_LANES (~0UL / 0xFFUL * 0x0FUL) // 0x0F0F...0F
+
+typedef void (*BcdColumnKernel)(unsigned long *even, unsigned long *odd, const unsigned long *x, size_t n);
+
+static void bcd_sum_column_scalar(unsigned long *restrict even, unsigned long *restrict odd,
+                                  const unsigned long *x, size_t n)
+{
+    for (size_t w = 0; w < n; w++) {
+        even[w] += x[w] & BCD_SUM_BYTE_LANES;
+        odd[w] += (x[w] >> 4) & BCD_SUM_BYTE_LANES;
+    }
+}
+
+#ifdef BCD_X86_DISPATCH
+// The byte mask repeats every byte, so 64-bit lanes give the same result for any word size
+__attribute__((target("avx2")))
+static void bcd_sum_column_avx2(unsigned long *even, unsigned long *odd, const unsigned long *x, size_t n)
+{
+    const size_t words_per_block = 32 / sizeof(unsigned long);
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t w = 0;
+
+    for (; w + words_per_block <= n; w += words_per_block) {
+        __m256i vx = _mm256_loadu_si256((const __m256i *)(x + w));
+        __m256i ve = _mm256_loadu_si256((const __m256i *)(even + w));
+        __m256i vo = _mm256_loadu_si256((const __m256i *)(odd + w));
+        ve = _mm256_add_epi64(ve, _mm256_and_si256(vx, mask));
+        vo = _mm256_add_epi64(vo, _mm256_and_si256(_mm256_srli_epi64(vx, 4), mask));
+        _mm256_storeu_si256((__m256i *)(even + w), ve);
+        _mm256_storeu_si256((__m256i *)(odd + w), vo);
+    }
+    bcd_sum_column_scalar(even + w, odd + w, x + w, n - w);
+}
+
+__attribute__((target("sse4.2")))
+static void bcd_sum_column_sse42(unsigned long *even, unsigned long *odd, const unsigned long *x, size_t n)
+{
+    const size_t words_per_block = 16 / sizeof(unsigned long);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t w = 0;
+
+    for (; w + words_per_block <= n; w += words_per_block) {
+        __m128i vx = _mm_loadu_si128((const __m128i *)(x + w));
+        __m128i ve = _mm_loadu_si128((const __m128i *)(even + w));
+        __m128i vo = _mm_loadu_si128((const __m128i *)(odd + w));
+        ve = _mm_add_epi64(ve, _mm_and_si128(vx, mask));
+        vo = _mm_add_epi64(vo, _mm_and_si128(_mm_srli_epi64(vx, 4), mask));
+        _mm_storeu_si128((__m128i *)(even + w), ve);
+        _mm_storeu_si128((__m128i *)(odd + w), vo);
+    }
+    bcd_sum_column_scalar(even + w, odd + w, x + w, n - w);
+}
+#endif
+
+// Selected by bcd_select_kernels() when the library loads; scalar until then
+static _Atomic(BcdWordKernel) bcd_add_kernel = bcd_add_n_scalar;
+static _Atomic(BcdWordKernel) bcd_sub_kernel = bcd_sub_n_scalar;
+static _Atomic(BcdColumnKernel) bcd_column_kernel = bcd_sum_column_scalar;
+static _Atomic(const char *) bcd_kernel_name = "scalar";
+
+static unsigned long bcd_add_n(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                               size_t n, unsigned long carry)
+{
+    return atomic_load_explicit(&bcd_add_kernel, memory_order_relaxed)(r, a, b, n, carry);
+}
+
+static unsigned long bcd_sub_n(unsigned long *r, const unsigned long *a, const unsigned long *b,
+                               size_t n, unsigned long borrow)
+{
+    return atomic_load_explicit(&bcd_sub_kernel, memory_order_relaxed)(r, a, b, n, borrow);
+}
+
+static void bcd_sum_column(unsigned long *even, unsigned long *odd, const unsigned long *x, size_t n)
+{
+    atomic_load_explicit(&bcd_column_kernel, memory_order_relaxed)(even, odd, x, n);
+}
+
+/**
+ * @brief Picks the fastest add/subtract and bcd_sum column kernels the CPU supports (cpuid via __builtin_cpu_supports).
+ * Setting the environment variable BCD_KERNELS=scalar keeps the portable kernel.
+ * All kernels produce bit-identical results. Runs automatically when the library is loaded
+ * (GCC/Clang); calling it again, from any thread, only repeats the choice.
+ */
+void bcd_select_kernels(void)
+{
+    const char *forced = getenv("BCD_KERNELS");
+    BcdWordKernel add = bcd_add_n_scalar, sub = bcd_sub_n_scalar;
+    BcdColumnKernel column = bcd_sum_column_scalar;
+    const char *name = "scalar";
+#ifdef BCD_X86_DISPATCH
+    if (!(forced && strcmp(forced, "scalar") == 0)) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            add = bcd_add_n_avx2;
+            sub = bcd_sub_n_avx2;
+            column = bcd_sum_column_avx2;
+            name = "avx2";
+        } else if (__builtin_cpu_supports("sse4.2")) {
+            add = bcd_add_n_sse42;
+            sub = bcd_sub_n_sse42;
+            column = bcd_sum_column_sse42;
+            name = "sse4.2";
+        }
+    }
+#else
+    (void)forced;
+#endif
+    atomic_store_explicit(&bcd_add_kernel, add, memory_order_relaxed);
+    atomic_store_explicit(&bcd_sub_kernel, sub, memory_order_relaxed);
+    atomic_store_explicit(&bcd_column_kernel, column, memory_order_relaxed);
+    atomic_store_explicit(&bcd_kernel_name, name, memory_order_relaxed);
+}
+
+#ifdef __GNUC__
+__attribute__((constructor)) static void bcd_select_kernels_at_load(void)
+{
+    bcd_select_kernels();
+}
+#endif
+
+const char *bcd_selected_kernels(void)
+{
+    return atomic_load_explicit(&bcd_kernel_name, memory_order_relaxed);
+}
+
+// --- Word-array helpers shared by comparison, multiplication and division ---
+#define BCD_WORDS_FOR_BITS(bits) (((bits) + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE)
+#define BCD_WORDS_FOR_DIGITS(digits) (((digits) + BCD_DIGITS_PER_WORD - 1) / BCD_DIGITS_PER_WORD)
+
+// Digit i (0 = least significant) of a packed word array
+static unsigned bcd_get_digit(const unsigned long *words, size_t i)
+{
+    return (unsigned)((words[i / BCD_DIGITS_PER_WORD] >> (4 * (i % BCD_DIGITS_PER_WORD))) & 0xFUL);
+}
+
+// Ripples a carry (0 or 1) into r[0..n), returns the carry out of the top word
+static unsigned long bcd_increment_n(unsigned long *r, size_t n, unsigned long carry)
+{
+    for (size_t w = 0; w < n && carry; w++) {
+        r[w] = bcd_word_add(r[w], 0, &carry);
+    }
+    return carry;
+}
+
+// Borrows a 0/1 through r[0..n), returns the borrow out of the top word
+static unsigned long bcd_decrement_n(unsigned long *r, size_t n, unsigned long borrow)
+{
+    for (size_t w = 0; w < n && borrow; w++) {
+        r[w] = bcd_word_sub(r[w], 0, &borrow);
+    }
+    return borrow;
+}
+
+// Length of a word array without its leading zero words
+static size_t bcd_significant_words(const unsigned long *x, size_t n)
+{
+    while (n > 0 && x[n - 1] == 0) n--;
+    return n;
+}
+
+// Number of significant digits in x[0..n) (0 for zero)
+static size_t bcd_digit_length(const unsigned long *x, size_t n)
+{
+    n = bcd_significant_words(x, n);
+    if (n == 0) return 0;
+#if defined(__GNUC__)
+    return n * BCD_DIGITS_PER_WORD - (size_t)__builtin_clzl(x[n - 1]) / 4;
+#else
+    size_t digits = n * BCD_DIGITS_PER_WORD;
+    unsigned long top = x[n - 1];
+    while ((top >> (BITSET_WORD_SIZE - 4)) == 0) { top <<= 4; digits--; }
+    return digits;
+#endif
+}
+
+// MSB-first magnitude compare of two n-word arrays
+static int bcd_compare_words(const unsigned long *x, const unsigned long *y, size_t n)
+{
+    for (size_t w = n; w-- > 0;) {
+        if (x[w] != y[w]) return (x[w] > y[w]) ? 1 : -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief r[0..nr) = x[0..nx) << bits, truncated to nr words (r may equal x).
+ * Whole words move with one memmove; the sub-word remainder is a funnel-shift fix-up pass.
+ * With bits = 4k this multiplies packed BCD by 10^k.
+ */
+static void bcd_shift_words_up(unsigned long *r, size_t nr, const unsigned long *x, size_t nx, size_t bits)
+{
+    size_t word_offset = bits / BITSET_WORD_SIZE;
+    unsigned bit_shift = (unsigned)(bits % BITSET_WORD_SIZE);
+    if (word_offset >= nr) { memset(r, 0, nr * sizeof(unsigned long)); return; }
+    size_t copy = (nx < nr - word_offset) ? nx : nr - word_offset;
+    memmove(r + word_offset, x, copy * sizeof(unsigned long));
+    memset(r + word_offset + copy, 0, (nr - word_offset - copy) * sizeof(unsigned long));
+    memset(r, 0, word_offset * sizeof(unsigned long));
+    if (bit_shift == 0) return;
+    for (size_t w = nr; w-- > word_offset;) {
+        unsigned long below = (w > word_offset) ? r[w - 1] : 0;
+        r[w] = (r[w] << bit_shift) | (below >> (BITSET_WORD_SIZE - bit_shift));
+    }
+}
+
+/**
+ * @brief r[0..nr) = x[0..nx) >> bits (r may equal x). With bits = 4k this is floor(x / 10^k).
+ */
+static void bcd_shift_words_down(unsigned long *r, size_t nr, const unsigned long *x, size_t nx, size_t bits)
+{
+    size_t word_offset = bits / BITSET_WORD_SIZE;
+    unsigned bit_shift = (unsigned)(bits % BITSET_WORD_SIZE);
+    size_t copy = (nx > word_offset) ? nx - word_offset : 0;
+    if (copy > nr) copy = nr;
+    unsigned long beyond = (word_offset + copy < nx) ? x[word_offset + copy] : 0; // Feeds the top bits
+    memmove(r, x + word_offset, copy * sizeof(unsigned long));
+    memset(r + copy, 0, (nr - copy) * sizeof(unsigned long));
+    if (bit_shift == 0) return;
+    for (size_t w = 0; w < copy; w++) {
+        unsigned long above = (w + 1 < copy) ? r[w + 1] : beyond;
+        r[w] = (r[w] >> bit_shift) | (above << (BITSET_WORD_SIZE - bit_shift));
+    }
+}
+
+/**
+ * @brief acc[0..acc_words) += src[0..src_words) * 10^digit_shift.
+ * The nibble shift is done on the fly with a funnel shift, so no shifted copy is made.
+ * Returns the carry out of acc.
+ */
+static unsigned long bcd_add_shifted(unsigned long *acc, size_t acc_words,
+                                     const unsigned long *src, size_t src_words, size_t digit_shift)
+{
+    size_t word_offset = digit_shift / BCD_DIGITS_PER_WORD;
+    unsigned bit_shift = (unsigned)(digit_shift % BCD_DIGITS_PER_WORD) * 4;
+    if (word_offset >= acc_words) return 0;
+    unsigned long *dst = acc + word_offset;
+    size_t dst_words = acc_words - word_offset;
+    unsigned long carry = 0;
+    size_t w = 0;
+
+    if (bit_shift == 0) {
+        w = (src_words < dst_words) ? src_words : dst_words;
+        carry = bcd_add_n(dst, dst, src, w, 0);
+    } else {
+        unsigned long prev = 0;
+        for (; w <= src_words && w < dst_words; w++) {
+            unsigned long cur = (w < src_words) ? src[w] : 0;
+            unsigned long piece = (cur << bit_shift) | (prev >> (BITSET_WORD_SIZE - bit_shift));
+            dst[w] = bcd_word_add(dst[w], piece, &carry);
+            prev = cur;
+        }
+    }
+    return bcd_increment_n(dst + w, dst_words - w, carry);
+}
+
+/**
+ * @brief acc[0..acc_words) -= src[0..src_words) * 10^digit_shift, the subtracting twin of
+ * bcd_add_shifted. Returns the borrow out of acc (1 when the result went negative).
+ */
+static unsigned long bcd_sub_shifted(unsigned long *acc, size_t acc_words,
+                                     const unsigned long *src, size_t src_words, size_t digit_shift)
+{
+    size_t word_offset = digit_shift / BCD_DIGITS_PER_WORD;
+    unsigned bit_shift = (unsigned)(digit_shift % BCD_DIGITS_PER_WORD) * 4;
+    if (word_offset >= acc_words) return 0;
+    unsigned long *dst = acc + word_offset;
+    size_t dst_words = acc_words - word_offset;
+    unsigned long borrow = 0;
+    size_t w = 0;
+
+    if (bit_shift == 0) {
+        w = (src_words < dst_words) ? src_words : dst_words;
+        borrow = bcd_sub_n(dst, dst, src, w, 0);
+    } else {
+        unsigned long prev = 0;
+        for (; w <= src_words && w < dst_words; w++) {
+            unsigned long cur = (w < src_words) ? src[w] : 0;
+            unsigned long piece = (cur << bit_shift) | (prev >> (BITSET_WORD_SIZE - bit_shift));
+            dst[w] = bcd_word_sub(dst[w], piece, &borrow);
+            prev = cur;
+        }
+    }
+    return bcd_decrement_n(dst + w, dst_words - w, borrow);
+}
+
+// BCD addition that RESIZES on carry out (word-parallel, BCD_DIGITS_PER_WORD digits per step)
+Bitset *bitset_add_with_carry(const Bitset *a, const Bitset *b)
+{
+    if (!a || !b) {
+        fprintf(stderr, "Error: NULL parameter passed to bitset_add_with_carry.\n");
+        return NULL;
+    }
+    if (a->size != b->size) {
+        fprintf(stderr, "Error: bitset_add_with_carry requires bitsets of equal size (%zu != %zu).\n", a->size, b->size);
+        return NULL;
+    }
+    if (a->size == 0) { // Handle empty input case
+        return bitset_create(0);
+    }
+
+
+    Bitset *result = bitset_create(a->size); // Start with same size
+    if (!result) return NULL;
+    if (!bitset_reserve(result, a->size + 4)) { bitset_free(result); return NULL; } // Room for the carry digit
+
+    size_t num_words = (a->size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    unsigned long carry;
+
+    // Bits beyond size are always zero, so a partial last word just adds zero digits
+    carry = bcd_add_n(result->data, a->data, b->data, num_words, 0);
+
+    // In a partial last word the carry out of the top digit lands in the next (unused) digit
+    size_t bits_in_last = a->size % BITSET_WORD_SIZE;
+    if (bits_in_last != 0) {
+        carry = (result->data[num_words - 1] >> bits_in_last) & 1UL;
+        result->data[num_words - 1] &= (1UL << bits_in_last) - 1;
+    }
+
+    // Handle final carry out by growing into the reserved digit
+    if (carry)
+    {
+        size_t old_size = result->size;
+        bitset_resize_in_place(result, old_size + 4); // Within capacity, cannot fail
+        // Set the first bit of the new digit (which represents '1')
+        bitset_set(result, old_size, true); // Set bit at index old_size (LSB of new digit)
+    }
+
+    return result;
+}
+
+/**
+ * @brief Adds the magnitude of b into acc in place (acc's sign is left alone). acc grows to the
+ * longer operand plus a carry digit as needed, reallocating only when it outgrows its capacity.
+ */
+bool bitset_add_in_place(Bitset *acc, const Bitset *b)
+{
+    if (!acc || !b) {
+        fprintf(stderr, "Error: NULL parameter passed to bitset_add_in_place.\n");
+        return false;
+    }
+    size_t size_b = ((b->size + 3) / 4) * 4;
+    size_t size_acc = ((acc->size + 3) / 4) * 4;
+    if (size_b > size_acc) size_acc = size_b;
+    if (!bitset_resize_in_place(acc, size_acc)) return false;
+
+    size_t nb = BCD_WORDS_FOR_BITS(b->size);
+    size_t n_acc = BCD_WORDS_FOR_BITS(acc->size);
+    unsigned long carry = bcd_add_n(acc->data, acc->data, b->data, nb, 0);
+    carry = bcd_increment_n(acc->data + nb, n_acc - nb, carry);
+    acc->digits = BITSET_DIGITS_UNKNOWN;
+
+    // A carry out of the top digit lands just past size in a partial word, or leaves the array
+    size_t bits_in_last = acc->size % BITSET_WORD_SIZE;
+    if (bits_in_last != 0) {
+        carry = (acc->data[n_acc - 1] >> bits_in_last) & 1UL;
+        acc->data[n_acc - 1] &= (1UL << bits_in_last) - 1;
+    }
+    if (carry) {
+        size_t old_size = acc->size;
+        if (!bitset_resize_in_place(acc, old_size + 4)) return false;
+        bitset_set(acc, old_size, true);
+    }
+    return true;
+}
+
+
+// Shifts bits toward the MSB within the current size (bits shifted past size are dropped)
+void bitset_shift_left(Bitset *bitset, size_t shift)
+{
+    if (!bitset || shift == 0 || bitset->size == 0) return;
+    bitset->digits = BITSET_DIGITS_UNKNOWN;
+    size_t num_words = BCD_WORDS_FOR_BITS(bitset->size);
+    bcd_shift_words_up(bitset->data, num_words, bitset->data, num_words, shift);
+    size_t bits_in_last = bitset->size % BITSET_WORD_SIZE;
+    if (bits_in_last != 0) bitset->data[num_words - 1] &= (1UL << bits_in_last) - 1; // Keep bits past size zero
+}
+
+// Shifts bits toward the LSB (low bits are dropped, zeros enter at the top)
+void bitset_shift_right(Bitset *bitset, size_t shift)
+{
+    if (!bitset || shift == 0 || bitset->size == 0) return;
+    bitset->digits = BITSET_DIGITS_UNKNOWN;
+    size_t num_words = BCD_WORDS_FOR_BITS(bitset->size);
+    bcd_shift_words_down(bitset->data, num_words, bitset->data, num_words, shift);
+}
+
+/**
+ * @brief Multiplies by 10^digits in place, growing size by 4 * digits bits so nothing is lost.
+ * Returns false (bitset unchanged) if the data cannot grow.
+ */
+bool bitset_shift_digits_left(Bitset *bitset, size_t digits)
+{
+    if (!bitset) return false;
+    if (digits == 0) return true;
+    size_t old_words = BCD_WORDS_FOR_BITS(bitset->size);
+    size_t new_size = bitset->size + 4 * digits;
+    size_t new_words = BCD_WORDS_FOR_BITS(new_size);
+    if (!bitset_reserve(bitset, new_size)) return false;
+    bitset->size = new_size;
+    bcd_shift_words_up(bitset->data, new_words, bitset->data, old_words, 4 * digits);
+    if (bitset->digits != BITSET_DIGITS_UNKNOWN && bitset->digits != 0) bitset->digits += digits;
+    return true;
+}
+
+/**
+ * @brief Divides the magnitude by 10^digits in place (truncating), dropping the low digits
+ * and shrinking size by as many nibbles (never below one digit).
+ */
+void bitset_shift_digits_right(Bitset *bitset, size_t digits)
+{
+    if (!bitset || digits == 0 || bitset->size == 0) return;
+    size_t known = bitset->digits;
+    bitset_shift_right(bitset, 4 * digits);
+    if (known != BITSET_DIGITS_UNKNOWN) bitset->digits = (known > digits) ? known - digits : 0;
+    bitset->size = (bitset->size > 4 * digits + 4) ? bitset->size - 4 * digits : 4;
+}
+
+
+// Four-character bit patterns of each nibble, MSB first
+static const char bcd_nibble_bits[16][4] = {
+    {'0','0','0','0'}, {'0','0','0','1'}, {'0','0','1','0'}, {'0','0','1','1'},
+    {'0','1','0','0'}, {'0','1','0','1'}, {'0','1','1','0'}, {'0','1','1','1'},
+    {'1','0','0','0'}, {'1','0','0','1'}, {'1','0','1','0'}, {'1','0','1','1'},
+    {'1','1','0','0'}, {'1','1','0','1'}, {'1','1','1','0'}, {'1','1','1','1'}
+};
+
+char *bitset_to_string_normal(const Bitset *bitset)
+{
+    if (!bitset || bitset->size == 0) {
+        // Return "0" for empty bitset? Or ""? Let's return "0000" to represent zero BCD.
+        // Or maybe let trim handle zero representation. Return "" if truly size 0.
+        char *empty_str = (char *)malloc(1);
+        if (empty_str) empty_str[0] = '\0';
+        return empty_str;
+    }
+    // Allocate size + 1 for null terminator
+    char *str = (char *)malloc(bitset->size + 1);
+    if (!str) return NULL;
+
+    if (bitset->size % 4 == 0) { // Whole digits: one table copy per nibble
+        size_t digits = bitset->size / 4;
+        for (size_t d = 0; d < digits; d++) {
+            size_t i = digits - 1 - d;
+            unsigned nibble = (unsigned)((bitset->data[i / BCD_DIGITS_PER_WORD] >> (4 * (i % BCD_DIGITS_PER_WORD))) & 0xFUL);
+            memcpy(str + 4 * d, bcd_nibble_bits[nibble], 4);
+        }
+        str[bitset->size] = '\0';
+        return str;
+    }
+    for (size_t i = 0; i < bitset->size; i++)
+    {
+        // Print bits with MSB first in string (index size-1-i)
+        str[i] = bitset_test(bitset, bitset->size - 1 - i) ? '1' : '0';
+    }
+    str[bitset->size] = '\0'; // Null terminate
+    return str;
+}
+
+
+// Compares MAGNITUDES only
+/**
+ * @brief Number of significant BCD digits (0 for zero), from a clz on the top nonzero word.
+ * Cached in bs->digits, so repeated calls on an unchanged bitset are O(1).
+ */
+size_t bitset_digit_length(const Bitset *bs)
+{
+    if (!bs) return 0;
+    // The cache is not part of the value, so filling it is allowed through const. Threads
+    // sharing a const Bitset may fill it at the same time (with the same value), so use
+    // relaxed atomic accesses where the compiler offers them.
+#ifdef __GNUC__
+    size_t digits = __atomic_load_n(&bs->digits, __ATOMIC_RELAXED);
+    if (digits == BITSET_DIGITS_UNKNOWN) {
+        digits = bcd_digit_length(bs->data, BCD_WORDS_FOR_BITS(bs->size));
+        __atomic_store_n(&((Bitset *)bs)->digits, digits, __ATOMIC_RELAXED);
+    }
+    return digits;
+#else
+    if (bs->digits == BITSET_DIGITS_UNKNOWN) {
+        ((Bitset *)bs)->digits = bcd_digit_length(bs->data, BCD_WORDS_FOR_BITS(bs->size));
+    }
+    return bs->digits;
+#endif
+}
+
+int bitset_compare(const Bitset *a, const Bitset *b)
+{
+    if (a == NULL && b == NULL) return 0;
+    if (a == NULL) return -1; // Consider NULL smaller
+    if (b == NULL) return 1;
+
+    // Different lengths decide it (O(1) once the lengths are cached)
+    size_t digits_a = bitset_digit_length(a);
+    size_t digits_b = bitset_digit_length(b);
+    if (digits_a != digits_b) return (digits_a > digits_b) ? 1 : -1;
+
+    // Same length: whole words from the most significant end
+    return bcd_compare_words(a->data, b->data, BCD_WORDS_FOR_DIGITS(digits_a));
+}
+
+/**
+ * @brief |a| - |b| in one LSB-to-MSB pass with decimal borrow.
+ * The sign comes from one MSB-first magnitude compare; only the result is allocated.
+ * Build with BCD_COMPLEMENT_SUBTRACT to use the 9's-complement reference path instead.
+ */
+Bitset *bitset_subtract_magnitude(const Bitset *a, const Bitset *b, bool *result_is_negative)
+{
+#ifdef BCD_COMPLEMENT_SUBTRACT
+    return bitset_subtract_magnitude_complement(a, b, result_is_negative);
+#else
+    *result_is_negative = false;
+    if (!a || !b) { fprintf(stderr, "Error: NULL input.\n"); return NULL; }
+
+    int cmp = bitset_compare(a, b);
+    const Bitset *larger = (cmp >= 0) ? a : b;
+    const Bitset *smaller = (cmp >= 0) ? b : a;
+    if (cmp < 0) { *result_is_negative = true; }
+
+    size_t common_size = (larger->size > smaller->size) ? larger->size : smaller->size;
+    if (common_size == 0) common_size = 4;
+    if (common_size % 4 != 0) { common_size = ((common_size + 3) / 4) * 4; }
+
+    Bitset *result = bitset_create(common_size);
+    if (!result) return NULL;
+
+    // Subtract over the words both operands have, then carry the borrow through the rest
+    // (either operand may be the longer one when the other has leading zeros)
+    size_t num_words = (common_size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    size_t larger_words = (larger->size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    size_t smaller_words = (smaller->size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    size_t shared_words = (larger_words < smaller_words) ? larger_words : smaller_words;
+
+    unsigned long borrow = bcd_sub_n(result->data, larger->data, smaller->data, shared_words, 0);
+    for (size_t w = shared_words; w < num_words; w++) {
+        unsigned long word_l = (w < larger_words) ? larger->data[w] : 0;
+        unsigned long word_s = (w < smaller_words) ? smaller->data[w] : 0;
+        result->data[w] = bcd_word_sub(word_l, word_s, &borrow);
+    }
+    // |larger| >= |smaller|, so the final borrow is always 0
+
+    result->is_negative = (cmp != 0) && *result_is_negative;
+    return result;
+#endif
+}
+
+// 9's-complement reference implementation: complement, add one, add, end-around carry
+Bitset *bitset_subtract_magnitude_complement(const Bitset *a, const Bitset *b, bool *result_is_negative)
+{
+
+    *result_is_negative = false;
+    if (!a || !b) { fprintf(stderr,"Error: NULL input.\n"); printf("--- Exiting subtract_magnitude (ERROR) ---\n"); return NULL;}
+
+    int cmp = bitset_compare(a, b);
+
+
+    const Bitset *larger = (cmp >= 0) ? a : b;
+    const Bitset *smaller = (cmp >= 0) ? b : a;
+    if (cmp < 0) { *result_is_negative = true; }
+
+
+    size_t common_size = (larger->size > smaller->size) ? larger->size : smaller->size;
+    if (common_size == 0) common_size = 4;
+    if (common_size % 4 != 0) { common_size = ((common_size + 3) / 4) * 4; }
+
+
+    Bitset *larger_padded = NULL, *smaller_padded = NULL;
+    Bitset *nines_comp_smaller = NULL, *one = NULL, *tens_comp_smaller = NULL;
+    Bitset *sum = NULL;
+    Bitset *final_result = NULL;
+    Bitset *operand1 = NULL, *operand2 = NULL; // Pointers for the final addition operands
+    bool operand1_resized = false, operand2_resized = false; // Track if resizing happened
+    size_t final_add_size = 0; // Initialize
+
+    larger_padded = bitset_resize(larger, common_size, false);
+    smaller_padded = bitset_resize(smaller, common_size, false);
+    if (!larger_padded || !smaller_padded) { /* Error handling */ goto subtract_cleanup_reverted; }
+
+    // Step 1: 9's complement
+    nines_comp_smaller = bitset_create(common_size);
+    if (!nines_comp_smaller) goto subtract_cleanup_reverted;
+    bcd_nines_complement(nines_comp_smaller->data, smaller_padded->data, common_size);
+
+
+    // Step 2: Calculate 10's complement (potentially resizing)
+    one = bitset_create(common_size);
+    if(!one) goto subtract_cleanup_reverted;
+    bitset_set(one, 0, true);
+
+    tens_comp_smaller = bitset_add_with_carry(nines_comp_smaller, one); // Uses resizing add
+    if (!tens_comp_smaller) { /* Error handling */ goto subtract_cleanup_reverted; }
+
+
+    // Determine size needed for final add based on potentially resized 10s comp
+    final_add_size = (larger_padded->size > tens_comp_smaller->size) ? larger_padded->size : tens_comp_smaller->size;
+
+    operand1 = larger_padded;
+    operand2 = tens_comp_smaller;
+    if (larger_padded->size < final_add_size) {
+
+        operand1 = bitset_resize(larger_padded, final_add_size, false);
+        if (!operand1) goto subtract_cleanup_reverted;
+        operand1_resized = true;
+    }
+    if (tens_comp_smaller->size < final_add_size) {
+
+        operand2 = bitset_resize(tens_comp_smaller, final_add_size, false);
+        if (!operand2) goto subtract_cleanup_reverted;
+        operand2_resized = true;
+    }
+
+
+    // Step 3: Add resized operands using resizing add
+
+    sum = bitset_add_with_carry(operand1, operand2); // Uses resizing add
+    if (!sum) { /* Error handling */ goto subtract_cleanup_reverted; }
+
+
+    // Step 4: Check end-around carry based on size difference
+    bool end_around_carry = (sum->size > final_add_size);
+
+
+    // Step 5: Determine final magnitude
+    if (end_around_carry) {
+        // Positive result: Discard carry by resizing sum back to final_add_size
+        // printf("Positive result path (discarding carry).\n"); // Debug
+        final_result = bitset_resize(sum, final_add_size, false);
+        if (!final_result) goto subtract_cleanup_reverted;
+    } else {
+        // No end-around carry
+        if (cmp == 0) {
+            // printf("Zero result path (inputs equal).\n"); // Debug
+            final_result = bitset_create(4);
+            if (!final_result) goto subtract_cleanup_reverted;
+        } else {
+            // Negative result path (cmp < 0)
+            // Magnitude = 10s_comp(sum) calculated relative to final_add_size
+
+            Bitset *nines_sum = bitset_create(final_add_size); // Use final_add_size
+            Bitset *one_sum = bitset_create(final_add_size);   // Use final_add_size
+            if (!nines_sum || !one_sum) { /* Error handling */ goto subtract_cleanup_reverted; }
+            bitset_set(one_sum, 0, true);
+
+            // Calculate 9's complement of 'sum' relative to final_add_size
+            bcd_nines_complement(nines_sum->data, sum->data, final_add_size); // sum->size == final_add_size here
+
+            // Add 1 to get 10s complement using resizing add
+            // printf("  Adding 1 to 9s_comp of sum...\n"); // Debug
+            final_result = bitset_add_with_carry(nines_sum, one_sum); // Uses resizing add
+
+            bitset_free(nines_sum);
+            bitset_free(one_sum);
+            if (!final_result) goto subtract_cleanup_reverted;
+
+        }
+    }
+
+    subtract_cleanup_reverted:
+    // Central cleanup point
+    bitset_free(larger_padded);
+    bitset_free(smaller_padded);
+    bitset_free(nines_comp_smaller);
+    bitset_free(one);
+    bitset_free(tens_comp_smaller); // Free the potentially resized 10s comp
+    bitset_free(sum);             // Free the potentially resized sum
+    // Free resized operands *only if they were created*
+    if (operand1_resized) bitset_free(operand1);
+    if (operand2_resized) bitset_free(operand2);
+    // final_result is the return value, don't free here
+
+    // Set sign on the final result (if it exists)...
+    if (final_result) {
+        bool is_zero_flag = true;
+        for(size_t k=0; k<final_result->size; ++k) if(bitset_test(final_result, k)) { is_zero_flag = false; break;}
+        if(is_zero_flag) final_result->is_negative = false;
+        else final_result->is_negative = *result_is_negative;
+
+    } else { /* Error message */ }
+
+
+    return final_result;
+}
+// --- End Complement Subtract Magnitude ---
+
+Bitset *int_to_bitset(int number)
+{
+    bool is_neg = false;
+    unsigned int abs_number;
+
+    if (number < 0)
+    {
+        is_neg = true;
+        if (number == INT_MIN) { abs_number = (unsigned int)INT_MAX + 1; }
+        else { abs_number = (unsigned int)(-number); }
+    } else {
+        abs_number = (unsigned int)number;
+    }
+
+    unsigned int temp = abs_number;
+    int digit_count = (temp == 0) ? 1 : 0;
+    while (temp > 0) { temp /= 10; digit_count++; }
+
+    size_t bcd_size = digit_count * 4;
+    Bitset *bitset = bitset_create(bcd_size);
+    if (!bitset) return NULL;
+
+    bitset->is_negative = is_neg;
+
+    temp = abs_number;
+    for (int i = 0; i < digit_count; i++) {
+        int digit = temp % 10;
+        temp /= 10;
+        for (int j = 0; j < 4; j++) {
+            if ((digit >> j) & 1) bitset_set(bitset, (i * 4) + j, true);
+            // else: bitset_set(bitset, (i * 4) + j, false); // Already zero from calloc
+        }
+    }
+    return bitset;
+}
+
+// Eight ASCII bytes as a little-endian word, so the first character is the low byte
+static uint64_t bcd_load8_ascii(const char *p)
+{
+    uint64_t chunk;
+    memcpy(&chunk, p, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    chunk = __builtin_bswap64(chunk);
+#endif
+    return chunk;
+}
+
+// True when all eight bytes are '0'..'9': high nibble 3, and low nibble + 6 stays below 16
+static bool bcd_ascii8_is_digits(uint64_t chunk)
+{
+    const uint64_t high_nibbles = 0xF0F0F0F0F0F0F0F0ULL, threes = 0x3030303030303030ULL;
+    return (chunk & high_nibbles) == threes &&
+           ((chunk + 0x0606060606060606ULL) & high_nibbles) == threes;
+}
+
+// Packs eight ASCII digits (first character most significant) into 32 bits of BCD
+static uint32_t bcd_ascii8_to_bcd(uint64_t chunk)
+{
+    chunk &= 0x0F0F0F0F0F0F0F0FULL;                                      // '0'..'9' -> 0..9
+    chunk = ((chunk << 4) | (chunk >> 8)) & 0x00FF00FF00FF00FFULL;       // Digit pairs
+    chunk = ((chunk << 8) | (chunk >> 16)) & 0x0000FFFF0000FFFFULL;      // Groups of four
+    return (uint32_t)((chunk << 16) | (chunk >> 32));                    // All eight
+}
+
+/**
+ * @brief Parses a decimal string of any length: optional surrounding whitespace, optional
+ * '+' or '-', then digits (leading zeros allowed). Eight digits are validated and packed
+ * per step from the least significant end.
+ * Returns NULL (and reports) on an empty or malformed string.
+ */
+Bitset *bitset_from_string(const char *str)
+{
+    if (!str) {
+        fprintf(stderr, "Error: NULL parameter passed to bitset_from_string.\n");
+        return NULL;
+    }
+    const char *p = str;
+    while (*p == ' ' || *p == '\t') p++;
+    bool is_neg = false;
+    if (*p == '+' || *p == '-') { is_neg = (*p == '-'); p++; }
+
+    const char *digits = p;
+    size_t len = strlen(digits);
+    while (len > 0 && (digits[len - 1] == ' ' || digits[len - 1] == '\t' ||
+                       digits[len - 1] == '\n' || digits[len - 1] == '\r')) len--;
+    if (len == 0) {
+        fprintf(stderr, "Error: '%s' is not a decimal number.\n", str);
+        return NULL;
+    }
+    while (len > 1 && *digits == '0') { digits++; len--; } // Leading zeros
+
+    Bitset *bitset = bitset_create(len * 4);
+    if (!bitset) return NULL;
+
+    // Whole groups of eight, least significant first
+    size_t group = 0;
+    for (; (group + 1) * 8 <= len; group++) {
+        uint64_t chunk = bcd_load8_ascii(digits + len - (group + 1) * 8);
+        if (!bcd_ascii8_is_digits(chunk)) {
+            fprintf(stderr, "Error: '%s' is not a decimal number.\n", str);
+            bitset_free(bitset);
+            return NULL;
+        }
+        size_t first_digit = group * 8;
+        bitset->data[first_digit / BCD_DIGITS_PER_WORD] |=
+            (unsigned long)bcd_ascii8_to_bcd(chunk) << (4 * (first_digit % BCD_DIGITS_PER_WORD));
+    }
+    // Leading len % 8 digits
+    for (size_t i = group * 8; i < len; i++) {
+        char c = digits[len - 1 - i];
+        if (c < '0' || c > '9') {
+            fprintf(stderr, "Error: '%s' is not a decimal number.\n", str);
+            bitset_free(bitset);
+            return NULL;
+        }
+        unsigned long digit = (unsigned long)(c - '0');
+        bitset->data[i / BCD_DIGITS_PER_WORD] |= digit << (4 * (i % BCD_DIGITS_PER_WORD));
+    }
+
+    bool is_zero = (len == 1 && digits[0] == '0');
+    bitset->is_negative = is_neg && !is_zero;
+    bitset->digits = is_zero ? 0 : len;
+    return bitset;
+}
+
+// --- Scratch arena ---
+// Temporaries of the word-level algorithms come from a BcdArena: a chain of blocks handed out
+// by bumping an offset and given back LIFO with mark/release, so an operation costs a few
+// block mallocs at most and nothing once a reused arena has grown to its working size.
+// An arena is not thread-safe; use one per thread.
+#define BCD_ARENA_MIN_BLOCK 4096
+#define BCD_ARENA_ALIGN 16
+
+typedef struct BcdArenaBlock
+{
+    struct BcdArenaBlock *next;
+    size_t base;     // Offset of this block in the arena (sum of earlier block capacities)
+    size_t capacity; // Usable bytes
+    size_t used;
+    unsigned char *bytes;
+} BcdArenaBlock;
+
+struct BcdArena
+{
+    BcdArenaBlock *first;
+    BcdArenaBlock *current;
+};
+
+static BcdArenaBlock *bcd_arena_block_new(size_t capacity, size_t base)
+{
+    size_t header = (sizeof(BcdArenaBlock) + BCD_ARENA_ALIGN - 1) / BCD_ARENA_ALIGN * BCD_ARENA_ALIGN;
+    BcdArenaBlock *block = (BcdArenaBlock *)malloc(header + capacity);
+    if (!block) { fprintf(stderr, "Error: malloc failed for arena block (%zu bytes)\n", capacity); return NULL; }
+    block->next = NULL;
+    block->base = base;
+    block->capacity = capacity;
+    block->used = 0;
+    block->bytes = (unsigned char *)block + header;
+    return block;
+}
+
+static void bcd_arena_free_chain(BcdArenaBlock *block)
+{
+    while (block) {
+        BcdArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+/**
+ * @brief Creates an arena whose first block holds initial_bytes (0 picks a small default).
+ * Returns NULL on allocation failure.
+ */
+BcdArena *bcd_arena_create(size_t initial_bytes)
+{
+    BcdArena *arena = (BcdArena *)malloc(sizeof(BcdArena));
+    if (!arena) { fprintf(stderr, "Error: malloc failed for BcdArena\n"); return NULL; }
+    if (initial_bytes < BCD_ARENA_MIN_BLOCK) initial_bytes = BCD_ARENA_MIN_BLOCK;
+    arena->first = bcd_arena_block_new(initial_bytes, 0);
+    if (!arena->first) { free(arena); return NULL; }
+    arena->current = arena->first;
+    return arena;
+}
+
+void bcd_arena_destroy(BcdArena *arena)
+{
+    if (!arena) return;
+    bcd_arena_free_chain(arena->first);
+    free(arena);
+}
+
+// Everything allocated so far is given back; the blocks are kept for reuse
+void bcd_arena_reset(BcdArena *arena)
+{
+    if (!arena) return;
+    arena->current = arena->first;
+    arena->first->used = 0;
+}
+
+// Position to hand to bcd_arena_release to free everything allocated after this call
+size_t bcd_arena_mark(const BcdArena *arena)
+{
+    return arena ? arena->current->base + arena->current->used : 0;
+}
+
+void bcd_arena_release(BcdArena *arena, size_t mark)
+{
+    if (!arena) return;
+    BcdArenaBlock *block = arena->first;
+    while (block->next && mark > block->base + block->capacity) block = block->next;
+    arena->current = block;
+    block->used = mark - block->base;
+}
+
+/**
+ * @brief Returns bytes of scratch memory (zeroed when asked), aligned for any word type.
+ * Moves on to the next block when the current one is full; a spare block that is too small
+ * is dropped along with everything after it and replaced by one at least twice as large.
+ */
+static void *bcd_arena_alloc(BcdArena *arena, size_t bytes, bool zero)
+{
+    bytes = (bytes + BCD_ARENA_ALIGN - 1) / BCD_ARENA_ALIGN * BCD_ARENA_ALIGN;
+    BcdArenaBlock *block = arena->current;
+    if (block->capacity - block->used < bytes) {
+        BcdArenaBlock *next = block->next;
+        if (!next || next->capacity < bytes) {
+            size_t capacity = 2 * block->capacity;
+            if (capacity < bytes) capacity = bytes;
+            BcdArenaBlock *fresh = bcd_arena_block_new(capacity, block->base + block->capacity);
+            if (!fresh) return NULL;
+            bcd_arena_free_chain(next);
+            block->next = fresh;
+            next = fresh;
+        }
+        next->used = 0;
+        arena->current = block = next;
+    }
+    void *p = block->bytes + block->used;
+    block->used += bytes;
+    if (zero) memset(p, 0, bytes);
+    return p;
+}
+
+#define BCD_ARENA_WORDS(arena, n, zero) ((unsigned long *)bcd_arena_alloc((arena), (n) * sizeof(unsigned long), (zero)))
+#define BCD_ARENA_LIMBS(arena, n, zero) ((uint32_t *)bcd_arena_alloc((arena), (n) * sizeof(uint32_t), (zero)))
+
+// Largest scratch estimate served from the per-thread arena; bigger calls get their own
+#define BCD_THREAD_ARENA_MAX_HINT (256 * 1024)
+
+/**
+ * @brief Scratch for one public call: the caller's arena, else the thread's shared arena
+ * for small operations, else a private one sized by hint_bytes.
+ */
+static BcdArena *bcd_scratch_open(BcdArena *arena, size_t hint_bytes, size_t *mark)
+{
+    if (!arena && hint_bytes <= BCD_THREAD_ARENA_MAX_HINT) {
+        if (!bcd_thread_arena) {
+            bcd_pool_arm_thread_exit();
+            bcd_thread_arena = bcd_arena_create(0);
+        }
+        arena = bcd_thread_arena;
+    } else if (!arena) {
+        arena = bcd_arena_create(hint_bytes);
+    }
+    *mark = bcd_arena_mark(arena);
+    return arena;
+}
+
+static void bcd_scratch_close(BcdArena *scratch, const BcdArena *callers, size_t mark)
+{
+    if (scratch == callers || scratch == bcd_thread_arena) bcd_arena_release(scratch, mark);
+    else bcd_arena_destroy(scratch);
+}
+
+/**
+ * @brief Schoolbook acc[0..acc_words) += a * b, or -= when subtract, straight into acc.
+ * The 1x..9x multiples of the shorter operand are built once (8 adds); every digit of the
+ * longer operand then costs one shifted accumulate of a table entry into acc.
+ * *out receives 1 if a carry (borrow) left the top of acc at any step.
+ */
+static bool bcd_mul_accumulate(BcdArena *arena, unsigned long *acc, size_t acc_words,
+                               const unsigned long *a, size_t na, const unsigned long *b, size_t nb,
+                               bool subtract, unsigned long *out)
+{
+    const unsigned long *x = a, *y = b; // x: digits walked, y: tabulated
+    size_t nx = na, ny = nb;
+    if (nb > na) { x = b; nx = nb; y = a; ny = na; }
+
+    *out = 0;
+    if (ny == 0) return true;
+
+    size_t entry_words = ny + 1; // 9 * y needs at most one extra digit
+    size_t mark = bcd_arena_mark(arena);
+    unsigned long *multiples = BCD_ARENA_WORDS(arena, 10 * entry_words, true);
+    if (!multiples) return false;
+
+    memcpy(multiples + entry_words, y, ny * sizeof(unsigned long));
+    for (unsigned d = 2; d <= 9; d++) {
+        unsigned long *prev = multiples + (d - 1) * entry_words;
+        unsigned long *cur = multiples + d * entry_words;
+        unsigned long carry = bcd_add_n(cur, prev, y, ny, 0);
+        cur[ny] = bcd_word_add(prev[ny], 0, &carry);
+    }
+
+    size_t x_digits = nx * BCD_DIGITS_PER_WORD;
+    for (size_t i = 0; i < x_digits; i++) {
+        unsigned digit = bcd_get_digit(x, i);
+        if (digit == 0) continue;
+        if (digit > 9) { fprintf(stderr, "Warning: Invalid BCD digit %u in multiplier. Skipping.\n", digit); continue; }
+        const unsigned long *entry = multiples + digit * entry_words;
+        *out |= subtract ? bcd_sub_shifted(acc, acc_words, entry, entry_words, i)
+                         : bcd_add_shifted(acc, acc_words, entry, entry_words, i);
+    }
+
+    bcd_arena_release(arena, mark);
+    return true;
+}
+
+/**
+ * @brief Schoolbook product r[0..na+nb) = a * b on packed word arrays.
+ */
+static bool bcd_mul_basecase(BcdArena *arena, unsigned long *r, const unsigned long *a, size_t na,
+                             const unsigned long *b, size_t nb)
+{
+    unsigned long carry;
+    memset(r, 0, (na + nb) * sizeof(unsigned long));
+    return bcd_mul_accumulate(arena, r, na + nb, a, na, b, nb, false, &carry);
+}
+
+/**
+ * @brief Schoolbook square r[0..2n) = a^2 computing every cross product once.
+ * With a = sum(w_k * B^k) over words, a^2 = sum(w_k^2 * B^2k) + 2 * sum(w_k * B^(2k+1) * T_(k+1)),
+ * where T_(k+1) is a with its low k+1 words dropped. The 1x..9x table of T_(k+1) is grown
+ * downward one word per step (d * T_k = d * w_k + B * d * T_(k+1)), so each digit of w_k
+ * is one shifted accumulate of a table entry, over half the width a full multiply uses.
+ */
+static bool bcd_sqr_basecase(BcdArena *arena, unsigned long *r, const unsigned long *a, size_t n)
+{
+    memset(r, 0, 2 * n * sizeof(unsigned long));
+    if (n == 0) return true;
+
+    size_t entry_words = n + 1; // Entry d of T_k lives in words [k, n] of its row
+    size_t mark = bcd_arena_mark(arena);
+    unsigned long *tails = BCD_ARENA_WORDS(arena, 10 * entry_words, true);
+    if (!tails) return false;
+
+    for (size_t k = n; k-- > 0;) {
+        // Cross products w_k * T_(k+1), placed at word 2k + 1
+        if (k + 1 < n) {
+            for (size_t i = 0; i < BCD_DIGITS_PER_WORD; i++) {
+                unsigned digit = bcd_get_digit(a + k, i);
+                if (digit == 0) continue;
+                if (digit > 9) { fprintf(stderr, "Warning: Invalid BCD digit %u in multiplier. Skipping.\n", digit); continue; }
+                unsigned long *entry = tails + digit * entry_words;
+                bcd_add_shifted(r, 2 * n, entry + k + 1, n - k, (2 * k + 1) * BCD_DIGITS_PER_WORD + i);
+            }
+        }
+
+        // Grow the table from T_(k+1) to T_k: the low word of d * w_k goes below, its carry digit on top
+        unsigned long low = 0, high = 0;
+        for (unsigned d = 1; d <= 9; d++) {
+            unsigned long carry = 0;
+            low = bcd_word_add(low, a[k], &carry);
+            high += carry;
+            unsigned long *entry = tails + d * entry_words;
+            entry[k] = low;
+            carry = 0;
+            entry[k + 1] = bcd_word_add(entry[k + 1], high, &carry);
+            bcd_increment_n(entry + k + 2, n - k - 1, carry);
+        }
+    }
+    bcd_arena_release(arena, mark);
+
+    // Double the cross products, then add the word squares w_k^2 at word 2k
+    bcd_add_n(r, r, r, 2 * n, 0);
+    unsigned long word_multiples[10][2] = {{0}};
+    for (size_t k = 0; k < n; k++) {
+        if (a[k] == 0) continue;
+        for (unsigned d = 1; d <= 9; d++) {
+            unsigned long carry = 0;
+            word_multiples[d][0] = bcd_word_add(word_multiples[d - 1][0], a[k], &carry);
+            word_multiples[d][1] = word_multiples[d - 1][1] + carry;
+        }
+        for (size_t i = 0; i < BCD_DIGITS_PER_WORD; i++) {
+            unsigned digit = bcd_get_digit(a + k, i);
+            if (digit == 0 || digit > 9) continue; // Invalid digits are skipped, as in the cross products
+            bcd_add_shifted(r, 2 * n, word_multiples[digit], 2, 2 * k * BCD_DIGITS_PER_WORD + i);
+        }
+    }
+    return true;
+}
+
+// --- Multiplication tiers ---
+// Cutoffs are in decimal digits of the shorter operand; see bcd_set_karatsuba_threshold()
+#define BCD_DEFAULT_KARATSUBA_THRESHOLD 320
+#define BCD_DEFAULT_TOOM3_THRESHOLD 2400
+#define BCD_DEFAULT_NTT_THRESHOLD 4000
+
+static atomic_size_t bcd_karatsuba_threshold = BCD_DEFAULT_KARATSUBA_THRESHOLD;
+static atomic_size_t bcd_toom3_threshold = BCD_DEFAULT_TOOM3_THRESHOLD;
+static atomic_size_t bcd_ntt_threshold = BCD_DEFAULT_NTT_THRESHOLD;
+
+/**
+ * @brief Sets the operand size (in digits) from which multiplication switches from the
+ * schoolbook kernel to Karatsuba. Values below two words are clamped.
+ */
+void bcd_set_karatsuba_threshold(size_t digits)
+{
+    if (digits < 2 * BCD_DIGITS_PER_WORD) digits = 2 * BCD_DIGITS_PER_WORD;
+    atomic_store_explicit(&bcd_karatsuba_threshold, digits, memory_order_relaxed);
+}
+
+size_t bcd_get_karatsuba_threshold(void)
+{
+    return atomic_load_explicit(&bcd_karatsuba_threshold, memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the operand size (in digits) from which multiplication uses Toom-Cook 3-way
+ * instead of Karatsuba. Values below three words are clamped.
+ */
+void bcd_set_toom3_threshold(size_t digits)
+{
+    if (digits < 3 * BCD_DIGITS_PER_WORD) digits = 3 * BCD_DIGITS_PER_WORD;
+    atomic_store_explicit(&bcd_toom3_threshold, digits, memory_order_relaxed);
+}
+
+size_t bcd_get_toom3_threshold(void)
+{
+    return atomic_load_explicit(&bcd_toom3_threshold, memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the operand size (in digits) from which multiplication uses the NTT tier.
+ * Products too long for the transform stay on Toom-3. Values below one word are clamped.
+ */
+void bcd_set_ntt_threshold(size_t digits)
+{
+    if (digits < BCD_DIGITS_PER_WORD) digits = BCD_DIGITS_PER_WORD;
+    atomic_store_explicit(&bcd_ntt_threshold, digits, memory_order_relaxed);
+}
+
+size_t bcd_get_ntt_threshold(void)
+{
+    return atomic_load_explicit(&bcd_ntt_threshold, memory_order_relaxed);
+}
+
+/**
+ * @brief Reads multiplication and division cutoffs from the environment
+ * (BCD_KARATSUBA_THRESHOLD, BCD_TOOM3_THRESHOLD, BCD_NTT_THRESHOLD, BCD_NEWTON_THRESHOLD,
+ * in digits) so they can be tuned per host without rebuilding.
+ */
+void bcd_tune_from_env(void)
+{
+    const char *value = getenv("BCD_KARATSUBA_THRESHOLD");
+    if (value && *value) bcd_set_karatsuba_threshold((size_t)strtoull(value, NULL, 10));
+    value = getenv("BCD_TOOM3_THRESHOLD");
+    if (value && *value) bcd_set_toom3_threshold((size_t)strtoull(value, NULL, 10));
+    value = getenv("BCD_NTT_THRESHOLD");
+    if (value && *value) bcd_set_ntt_threshold((size_t)strtoull(value, NULL, 10));
+    value = getenv("BCD_NEWTON_THRESHOLD");
+    if (value && *value) bcd_set_newton_threshold((size_t)strtoull(value, NULL, 10));
+}
+
+// r[0..n) = a[0..na) + b[0..nb) with na, nb <= n; the final carry goes into the top word.
+// r may be a or b itself.
+static void bcd_add_words(unsigned long *r, size_t n, const unsigned long *a, size_t na,
+                          const unsigned long *b, size_t nb)
+{
+    if (na < nb) { const unsigned long *t = a; a = b; b = t; size_t tn = na; na = nb; nb = tn; }
+    unsigned long carry = bcd_add_n(r, a, b, nb, 0);
+    if (r != a) memcpy(r + nb, a + nb, (na - nb) * sizeof(unsigned long));
+    memset(r + na, 0, (n - na) * sizeof(unsigned long));
+    bcd_increment_n(r + nb, n - nb, carry);
+}
+
+// x[0..nx) -= y[0..ny) with ny <= nx and x >= y
+static void bcd_sub_in_place(unsigned long *x, size_t nx, const unsigned long *y, size_t ny)
+{
+    unsigned long borrow = bcd_sub_n(x, x, y, ny, 0);
+    bcd_decrement_n(x + ny, nx - ny, borrow);
+}
+
+static bool bcd_mul_words(BcdArena *arena, unsigned long *r, const unsigned long *a, size_t na,
+                          const unsigned long *b, size_t nb);
+
+// Unbalanced operands (na >= 2 * nb): multiply nb-word slices of a by b and accumulate
+static bool bcd_mul_unbalanced(BcdArena *arena, unsigned long *r, const unsigned long *a, size_t na,
+                               const unsigned long *b, size_t nb)
+{
+    size_t total = na + nb;
+    size_t mark = bcd_arena_mark(arena);
+    unsigned long *slice = BCD_ARENA_WORDS(arena, 2 * nb, false);
+    if (!slice) return false;
+    memset(r, 0, total * sizeof(unsigned long));
+    bool ok = true;
+    for (size_t off = 0; off < na; off += nb) {
+        size_t len = (na - off < nb) ? na - off : nb;
+        ok = bcd_mul_words(arena, slice, a + off, len, b, nb);
+        if (!ok) break;
+        unsigned long carry = bcd_add_n(r + off, r + off, slice, len + nb, 0);
+        bcd_increment_n(r + off + len + nb, total - off - len - nb, carry);
+    }
+    bcd_arena_release(arena, mark);
+    return ok;
+}
+
+/**
+ * @brief Karatsuba step for nb <= na < 2 * nb, both above the cutoff. Splits on a word boundary
+ * (h words = h * BCD_DIGITS_PER_WORD digits) so every shift by 10^h is a word offset:
+ * a*b = z2*10^2h + ((a0+a1)(b0+b1) - z0 - z2)*10^h + z0. Squaring makes all three squares.
+ */
+static bool bcd_mul_karatsuba(BcdArena *arena, unsigned long *r, const unsigned long *a, size_t na,
+                              const unsigned long *b, size_t nb)
+{
+    size_t total = na + nb;
+    size_t h = (na + 1) / 2;
+    size_t mark = bcd_arena_mark(arena);
+    if (nb <= h) {
+        // b has no high half: a*b = a0*b + a1*b*10^h
+        unsigned long *high = BCD_ARENA_WORDS(arena, na - h + nb, false);
+        bool ok = high && bcd_mul_words(arena, r, a, h, b, nb) && bcd_mul_words(arena, high, a + h, na - h, b, nb);
+        if (ok) {
+            memset(r + h + nb, 0, (total - h - nb) * sizeof(unsigned long));
+            unsigned long carry = bcd_add_n(r + h, r + h, high, nb, 0);
+            memcpy(r + h + nb, high + nb, (na - h) * sizeof(unsigned long));
+            bcd_increment_n(r + h + nb, total - h - nb, carry);
+        }
+        bcd_arena_release(arena, mark);
+        return ok;
+    }
+
+    unsigned long *sum_a = BCD_ARENA_WORDS(arena, 4 * h + 4, false);
+    if (!sum_a) return false;
+    unsigned long *sum_b = sum_a + (h + 1);
+    unsigned long *middle = sum_b + (h + 1); // 2h + 2 words
+
+    bcd_add_words(sum_a, h + 1, a, h, a + h, na - h);
+    if (a == b && na == nb) {
+        sum_b = sum_a; // Squaring: all three products below become squares
+    } else {
+        bcd_add_words(sum_b, h + 1, b, h, b + h, nb - h);
+    }
+
+    // z0 -> r[0..2h), z2 -> r[2h..total), z1 -> middle
+    if (!bcd_mul_words(arena, r, a, h, b, h) ||
+        !bcd_mul_words(arena, r + 2 * h, a + h, na - h, b + h, nb - h) ||
+        !bcd_mul_words(arena, middle, sum_a, h + 1, sum_b, h + 1)) {
+        bcd_arena_release(arena, mark);
+        return false;
+    }
+
+    bcd_sub_in_place(middle, 2 * h + 2, r, 2 * h);
+    bcd_sub_in_place(middle, 2 * h + 2, r + 2 * h, total - 2 * h);
+
+    size_t mid_len = bcd_significant_words(middle, 2 * h + 2);
+    unsigned long carry = bcd_add_n(r + h, r + h, middle, mid_len, 0);
+    bcd_increment_n(r + h + mid_len, total - h - mid_len, carry);
+
+    bcd_arena_release(arena, mark);
+    return true;
+}
+
+// Eight packed BCD digits to binary: digit pairs, then 4-digit halves, then the whole
+static uint32_t bcd_unpack8(uint32_t packed)
+{
+    packed = (packed & 0x0F0F0F0FU) + ((packed >> 4) & 0x0F0F0F0FU) * 10;
+    packed = (packed & 0x00FF00FFU) + ((packed >> 8) & 0x00FF00FFU) * 100;
+    return (packed & 0xFFFFU) + (packed >> 16) * 10000;
+}
+
+// Binary value below 10^8 to eight packed BCD digits (the four 0..99 pairs split in 16-bit lanes)
+static uint32_t bcd_pack8(uint32_t value)
+{
+    uint32_t hi = value / 10000, lo = value % 10000;
+    uint64_t pairs = (uint64_t)(lo % 100) | (uint64_t)(lo / 100) << 16 |
+                     (uint64_t)(hi % 100) << 32 | (uint64_t)(hi / 100) << 48;
+    uint64_t tens = ((pairs * 103) >> 10) & 0x000F000F000F000FULL; // Lane-wise floor(pair / 10)
+    pairs += tens * 6;                                              // pair + 6 * tens = tens:ones
+    return (uint32_t)(pairs & 0xFF) | (uint32_t)((pairs >> 16) & 0xFF) << 8 |
+           (uint32_t)((pairs >> 32) & 0xFF) << 16 | (uint32_t)((pairs >> 48) & 0xFF) << 24;
+}
+
+/**
+ * @brief q = x / divisor over n words from the MSB; returns the remainder.
+ * Works on eight digits per step: the running remainder times 10^8 plus the next eight
+ * digits still fits a uint64_t for any 32-bit divisor. q may alias x or be NULL (remainder only).
+ */
+static uint32_t bcd_divmod_small_words(unsigned long *q, const unsigned long *x, size_t n, uint32_t divisor)
+{
+    const size_t chunks = BITSET_WORD_SIZE / 32;
+    uint64_t rem = 0;
+    for (size_t w = n; w-- > 0;) {
+        unsigned long word = x[w], q_word = 0;
+        for (size_t c = chunks; c-- > 0;) {
+            uint64_t cur = rem * 100000000ULL + bcd_unpack8((uint32_t)(word >> (32 * c)));
+            q_word |= (unsigned long)bcd_pack8((uint32_t)(cur / divisor)) << (32 * c);
+            rem = cur % divisor;
+        }
+        if (q) q[w] = q_word;
+    }
+    return (uint32_t)rem;
+}
+
+// Sign-magnitude value over a fixed number of words (Toom-3 intermediates)
+typedef struct
+{
+    unsigned long *d;
+    bool is_negative;
+} BcdSignedWords;
+
+// r = x + y (or x - y when subtract) over n words; r may alias x or y
+static void bcd_signed_add(BcdSignedWords *r, const BcdSignedWords *x, const BcdSignedWords *y,
+                           bool subtract, size_t n)
+{
+    bool y_negative = y->is_negative != subtract;
+    if (x->is_negative == y_negative) {
+        bcd_add_n(r->d, x->d, y->d, n, 0); // Callers size n so this never carries out
+        r->is_negative = x->is_negative;
+    } else if (bcd_compare_words(x->d, y->d, n) >= 0) {
+        bcd_sub_n(r->d, x->d, y->d, n, 0);
+        r->is_negative = x->is_negative;
+    } else {
+        bcd_sub_n(r->d, y->d, x->d, n, 0);
+        r->is_negative = y_negative;
+    }
+    if (r->is_negative && bcd_significant_words(r->d, n) == 0) r->is_negative = false;
+}
+
+// Exact x /= divisor keeping the sign
+static void bcd_signed_divexact(BcdSignedWords *x, unsigned divisor, size_t n)
+{
+    bcd_divmod_small_words(x->d, x->d, n, divisor);
+}
+
+// Copies the k-word piece of x starting at word `from` (clipped to nx) into an n-word value
+static void bcd_signed_load(BcdSignedWords *r, const unsigned long *x, size_t nx, size_t from, size_t k, size_t n)
+{
+    size_t len = (from >= nx) ? 0 : ((nx - from < k) ? nx - from : k);
+    memset(r->d, 0, n * sizeof(unsigned long));
+    if (len) memcpy(r->d, x + from, len * sizeof(unsigned long));
+    r->is_negative = false;
+}
+
+/**
+ * @brief Evaluates x0 + x1*t + x2*t^2 at t = 1, -1, -2 (pieces p[0..2], n words each).
+ * e[0] = x(1), e[1] = x(-1), e[2] = x(-2).
+ */
+static void bcd_toom3_evaluate(BcdSignedWords *e, const BcdSignedWords *p, size_t n)
+{
+    bcd_signed_add(&e[0], &p[0], &p[2], false, n);   // x0 + x2
+    bcd_signed_add(&e[1], &e[0], &p[1], true, n);    // x(-1) = x0 - x1 + x2
+    bcd_signed_add(&e[0], &e[0], &p[1], false, n);   // x(1)  = x0 + x1 + x2
+    bcd_signed_add(&e[2], &e[1], &p[2], false, n);   // x0 - x1 + 2x2
+    bcd_signed_add(&e[2], &e[2], &e[2], false, n);   // 2x0 - 2x1 + 4x2
+    bcd_signed_add(&e[2], &e[2], &p[0], true, n);    // x(-2) = x0 - 2x1 + 4x2
+}
+
+/**
+ * @brief Toom-Cook 3-way step for na >= nb with nb > 2k, k = ceil(na / 3) words.
+ * Evaluates at 0, 1, -1, -2 and infinity, multiplies the five values through the tier
+ * dispatcher and interpolates with exact divisions by 2 and 3 (Bodrato's sequence).
+ * When a and b are the same array the five products are squares.
+ */
+static bool bcd_mul_toom3(BcdArena *arena, unsigned long *r, const unsigned long *a, size_t na,
+                          const unsigned long *b, size_t nb)
+{
+    size_t k = (na + 2) / 3;
+    size_t total = na + nb;
+    size_t n = 2 * k + 3; // Width of every signed intermediate
+
+    enum { PA = 0, PB = 3, EA = 6, EB = 9, V1 = 12, VM1, VM2, V0, VINF, T1, T2, T3, NUM_VALUES };
+    size_t mark = bcd_arena_mark(arena);
+    unsigned long *block = BCD_ARENA_WORDS(arena, NUM_VALUES * n, true);
+    if (!block) return false;
+    BcdSignedWords v[NUM_VALUES];
+    for (int i = 0; i < NUM_VALUES; i++) { v[i].d = block + i * n; v[i].is_negative = false; }
+
+    for (size_t i = 0; i < 3; i++) {
+        bcd_signed_load(&v[PA + i], a, na, i * k, k, n);
+        bcd_signed_load(&v[PB + i], b, nb, i * k, k, n);
+    }
+    bool square = (a == b && na == nb);
+    bcd_toom3_evaluate(&v[EA], &v[PA], n);
+    if (!square) bcd_toom3_evaluate(&v[EB], &v[PB], n);
+    int eb = square ? EA : EB; // Squaring evaluates once and squares the five values
+
+    // Point values: v0 and vinf straight into r, the others into n-word temporaries
+    bool ok = bcd_mul_words(arena, r, a, k, b, k) &&
+              bcd_mul_words(arena, r + 4 * k, a + 2 * k, na - 2 * k, b + 2 * k, nb - 2 * k);
+    for (int i = 0; ok && i < 3; i++) {
+        ok = bcd_mul_words(arena, v[V1 + i].d, v[EA + i].d, k + 1, v[eb + i].d, k + 1);
+        v[V1 + i].is_negative = v[EA + i].is_negative != v[eb + i].is_negative &&
+                                bcd_significant_words(v[V1 + i].d, n) != 0;
+    }
+    if (!ok) { bcd_arena_release(arena, mark); return false; }
+    memset(r + 2 * k, 0, 2 * k * sizeof(unsigned long));
+    bcd_signed_load(&v[V0], r, total, 0, 2 * k, n);
+    bcd_signed_load(&v[VINF], r, total, 4 * k, total - 4 * k, n);
+
+    // Interpolation: T1 = r1, T2 = r2, T3 = r3
+    bcd_signed_add(&v[T3], &v[VM2], &v[V1], true, n);
+    bcd_signed_divexact(&v[T3], 3, n);                    // (v(-2) - v(1)) / 3
+    bcd_signed_add(&v[T1], &v[V1], &v[VM1], true, n);
+    bcd_signed_divexact(&v[T1], 2, n);                    // (v(1) - v(-1)) / 2
+    bcd_signed_add(&v[T2], &v[VM1], &v[V0], true, n);     // v(-1) - v(0)
+    bcd_signed_add(&v[T3], &v[T2], &v[T3], true, n);
+    bcd_signed_divexact(&v[T3], 2, n);
+    bcd_signed_add(&v[T3], &v[T3], &v[VINF], false, n);
+    bcd_signed_add(&v[T3], &v[T3], &v[VINF], false, n);   // r3 = (r2 - r3) / 2 + 2 vinf
+    bcd_signed_add(&v[T2], &v[T2], &v[T1], false, n);
+    bcd_signed_add(&v[T2], &v[T2], &v[VINF], true, n);    // r2 = r2 + r1 - vinf
+    bcd_signed_add(&v[T1], &v[T1], &v[T3], true, n);      // r1 = r1 - r3
+
+    // r1, r2, r3 are coefficients of the product, hence non-negative
+    for (size_t i = 0; i < 3; i++) {
+        size_t offset = (i + 1) * k;
+        size_t len = bcd_significant_words(v[T1 + i].d, n);
+        if (len > total - offset) len = total - offset;
+        unsigned long carry = bcd_add_n(r + offset, r + offset, v[T1 + i].d, len, 0);
+        bcd_increment_n(r + offset + len, total - offset - len, carry);
+    }
+
+    bcd_arena_release(arena, mark);
+    return true;
+}
+
+// --- Number-theoretic transform tier ---
+// Digits are regrouped 4 per element (base 10^4) and convolved modulo two NTT primes;
+// the CRT recombination is exact while 9999^2 * min(elements) < p1 * p2.
+#define BCD_NTT_P1 998244353u  // 119 * 2^23 + 1, generator 3
+#define BCD_NTT_P2 469762049u  // 7 * 2^26 + 1, generator 3
+#define BCD_NTT_MAX_LOG2 23    // Largest transform both primes support
+#define BCD_NTT_GROUPS_PER_WORD (BITSET_WORD_SIZE / 16)
+
+static uint32_t bcd_ntt_pow(uint32_t base, uint64_t exp, uint32_t mod)
+{
+    uint64_t result = 1, b = base;
+    while (exp) {
+        if (exp & 1) result = result * b % mod;
+        b = b * b % mod;
+        exp >>= 1;
+    }
+    return (uint32_t)result;
+}
+
+// In-place iterative radix-2 transform of length n (a power of two) modulo mod
+static void bcd_ntt_transform(uint32_t *x, size_t n, uint32_t mod, bool inverse)
+{
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) { uint32_t t = x[i]; x[i] = x[j]; x[j] = t; }
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        uint32_t step = bcd_ntt_pow(3, (mod - 1) / len, mod);
+        if (inverse) step = bcd_ntt_pow(step, mod - 2, mod);
+        for (size_t i = 0; i < n; i += len) {
+            uint64_t w = 1;
+            for (size_t j = 0; j < len / 2; j++) {
+                uint32_t u = x[i + j];
+                uint32_t v = (uint32_t)(x[i + j + len / 2] * w % mod);
+                x[i + j] = (u + v >= mod) ? u + v - mod : u + v;
+                x[i + j + len / 2] = (u >= v) ? u - v : u + mod - v;
+                w = w * step % mod;
+            }
+        }
+    }
+    if (inverse) {
+        uint64_t n_inv = bcd_ntt_pow((uint32_t)(n % mod), mod - 2, mod);
+        for (size_t i = 0; i < n; i++) x[i] = (uint32_t)(x[i] * n_inv % mod);
+    }
+}
+
+// Unpacks 4-digit groups of a packed word array into base-10^4 elements (zero padded to n)
+static void bcd_ntt_unpack(uint32_t *dst, size_t n, const unsigned long *x, size_t nx)
+{
+    size_t groups = nx * BCD_NTT_GROUPS_PER_WORD;
+    for (size_t g = 0; g < groups; g++) {
+        unsigned long bits = (x[g / BCD_NTT_GROUPS_PER_WORD] >> (16 * (g % BCD_NTT_GROUPS_PER_WORD))) & 0xFFFFUL;
+        dst[g] = (uint32_t)((bits & 0xF) + 10 * ((bits >> 4) & 0xF) + 100 * ((bits >> 8) & 0xF) + 1000 * (bits >> 12));
+    }
+    memset(dst + groups, 0, (n - groups) * sizeof(uint32_t));
+}
+
+// Largest element count (ea + eb) the transform can take
+static size_t bcd_ntt_max_groups(void)
+{
+    return (size_t)1 << BCD_NTT_MAX_LOG2;
+}
+
+/**
+ * @brief r[0..na+nb) = a * b through two NTT convolutions, CRT and base-10^4 carry
+ * normalisation written straight back as packed BCD. Exact; same digits as the other tiers.
+ */
+static bool bcd_mul_ntt(BcdArena *arena, unsigned long *r, const unsigned long *a, size_t na,
+                        const unsigned long *b, size_t nb)
+{
+    size_t groups = (na + nb) * BCD_NTT_GROUPS_PER_WORD;
+    size_t n = 1;
+    while (n < groups) n <<= 1;
+
+    bool square = (a == b && na == nb); // One forward transform per prime when squaring
+    size_t mark = bcd_arena_mark(arena);
+    uint32_t *buf = BCD_ARENA_LIMBS(arena, (square ? 2 : 4) * n, false);
+    if (!buf) return false;
+    uint32_t *a1 = buf, *a2 = buf + n, *b1 = a1, *b2 = a2;
+
+    bcd_ntt_unpack(a1, n, a, na);
+    memcpy(a2, a1, n * sizeof(uint32_t));
+    if (!square) {
+        b1 = buf + 2 * n;
+        b2 = buf + 3 * n;
+        bcd_ntt_unpack(b1, n, b, nb);
+        memcpy(b2, b1, n * sizeof(uint32_t));
+    }
+
+    const uint32_t primes[2] = { BCD_NTT_P1, BCD_NTT_P2 };
+    uint32_t *as[2] = { a1, a2 }, *bs[2] = { b1, b2 };
+    for (int p = 0; p < 2; p++) {
+        bcd_ntt_transform(as[p], n, primes[p], false);
+        if (!square) bcd_ntt_transform(bs[p], n, primes[p], false);
+        for (size_t i = 0; i < n; i++) as[p][i] = (uint32_t)((uint64_t)as[p][i] * bs[p][i] % primes[p]);
+        bcd_ntt_transform(as[p], n, primes[p], true);
+    }
+
+    // CRT: c = r1 + p1 * ((r2 - r1) * p1^-1 mod p2), then carry in base 10^4
+    const uint64_t p1_inv = bcd_ntt_pow(BCD_NTT_P1 % BCD_NTT_P2, BCD_NTT_P2 - 2, BCD_NTT_P2);
+    uint64_t carry = 0;
+    memset(r, 0, (na + nb) * sizeof(unsigned long));
+    for (size_t g = 0; g < groups; g++) {
+        uint64_t r1 = a1[g], r2 = a2[g];
+        uint64_t t = (r2 + BCD_NTT_P2 - r1 % BCD_NTT_P2) % BCD_NTT_P2 * p1_inv % BCD_NTT_P2;
+        uint64_t value = r1 + (uint64_t)BCD_NTT_P1 * t + carry;
+        unsigned group = (unsigned)(value % 10000);
+        carry = value / 10000;
+        unsigned long packed = (unsigned long)(group % 10) | (unsigned long)(group / 10 % 10) << 4 |
+                               (unsigned long)(group / 100 % 10) << 8 | (unsigned long)(group / 1000) << 12;
+        r[g / BCD_NTT_GROUPS_PER_WORD] |= packed << (16 * (g % BCD_NTT_GROUPS_PER_WORD));
+    }
+    // The product fits in na + nb words, so carry is 0 here
+
+    bcd_arena_release(arena, mark);
+    return true;
+}
+
+/**
+ * @brief r[0..na+nb) = a * b, picking the multiplication tier by operand size.
+ * Passing the same array for a and b (with na == nb) squares at every tier.
+ * r must not overlap a or b.
+ */
+static bool bcd_mul_words(BcdArena *arena, unsigned long *r, const unsigned long *a, size_t na,
+                          const unsigned long *b, size_t nb)
+{
+    size_t sig_a = bcd_significant_words(a, na);
+    size_t sig_b = bcd_significant_words(b, nb);
+    memset(r + sig_a + sig_b, 0, (na + nb - sig_a - sig_b) * sizeof(unsigned long));
+    if (sig_a < sig_b) {
+        const unsigned long *t = a; a = b; b = t;
+        size_t tn = sig_a; sig_a = sig_b; sig_b = tn;
+    }
+
+    size_t karatsuba_words = bcd_get_karatsuba_threshold() / BCD_DIGITS_PER_WORD;
+    size_t toom3_words = bcd_get_toom3_threshold() / BCD_DIGITS_PER_WORD;
+    size_t ntt_words = bcd_get_ntt_threshold() / BCD_DIGITS_PER_WORD;
+    if (sig_b < karatsuba_words) {
+        if (a == b) return bcd_sqr_basecase(arena, r, a, sig_a);
+        return bcd_mul_basecase(arena, r, a, sig_a, b, sig_b);
+    }
+    if (sig_a >= 2 * sig_b) {
+        return bcd_mul_unbalanced(arena, r, a, sig_a, b, sig_b);
+    }
+    if (sig_b >= ntt_words && (sig_a + sig_b) * BCD_NTT_GROUPS_PER_WORD <= bcd_ntt_max_groups()) {
+        return bcd_mul_ntt(arena, r, a, sig_a, b, sig_b);
+    }
+    if (sig_b >= toom3_words && sig_b > 2 * ((sig_a + 2) / 3)) {
+        return bcd_mul_toom3(arena, r, a, sig_a, b, sig_b);
+    }
+    return bcd_mul_karatsuba(arena, r, a, sig_a, b, sig_b);
+}
+
+// Multiplication Magnitude (schoolbook digit-multiple table, Karatsuba / Toom-3 / NTT above the cutoffs)
+Bitset *bcd_multiply_magnitude(const Bitset *a, const Bitset *b)
+{
+    return bcd_multiply_magnitude_ex(a, b, NULL);
+}
+
+Bitset *bcd_multiply_magnitude_ex(const Bitset *a, const Bitset *b, BcdArena *arena)
+{
+    if (!a || !b) return NULL;
+    bool square = (a == b) || bitset_compare(a, b) == 0; // Equal magnitudes: use the squaring kernels
+
+    size_t size_a = ((a->size + 3) / 4) * 4; if (size_a == 0) size_a = 4;
+    size_t size_b = ((b->size + 3) / 4) * 4; if (size_b == 0) size_b = 4;
+    size_t result_size = size_a + size_b; // Max possible size
+
+    Bitset *total_product = bitset_create(result_size);
+    if (!total_product) return NULL;
+
+    size_t na = BCD_WORDS_FOR_BITS(a->size);
+    size_t nb = BCD_WORDS_FOR_BITS(b->size);
+    if (na == 0 || nb == 0) return total_product; // Empty operand: product is zero
+
+    size_t nsq = (na < nb) ? na : nb; // Equal values fit in the shorter array
+    size_t mark;
+    BcdArena *scratch = bcd_scratch_open(arena, 4 * (na + nb) * sizeof(unsigned long), &mark);
+    unsigned long *product = scratch ? BCD_ARENA_WORDS(scratch, na + nb, true) : NULL;
+    bool ok = product && (square ? bcd_mul_words(scratch, product, a->data, nsq, a->data, nsq)
+                                 : bcd_mul_words(scratch, product, a->data, na, b->data, nb));
+    if (ok) {
+        // The product fits in size_a + size_b bits, so any words past that are zero
+        memcpy(total_product->data, product, BCD_WORDS_FOR_BITS(result_size) * sizeof(unsigned long));
+    }
+    if (scratch) bcd_scratch_close(scratch, arena, mark);
+    if (!ok) {
+        fprintf(stderr, "Multiplication resulted in NULL, likely due to error.\n");
+        bitset_free(total_product);
+        return NULL;
+    }
+
+    return total_product;
+}
+
+
+/**
+ * @brief Squares the magnitude of a. Same tiers as bcd_multiply_magnitude, but every
+ * cross product is computed once and doubled (schoolbook), Karatsuba / Toom-3 recurse on
+ * squares and the NTT transforms the operand once.
+ */
+Bitset *bcd_square(const Bitset *a)
+{
+    return bcd_multiply_magnitude_ex(a, a, NULL);
+}
+
+Bitset *bcd_square_ex(const Bitset *a, BcdArena *arena)
+{
+    return bcd_multiply_magnitude_ex(a, a, arena);
+}
+
+
+// --- Division ---
+
+// Digits [lo, lo + count) of x as a machine integer, count <= 19
+static uint64_t bcd_read_digits(const unsigned long *x, size_t lo, size_t count)
+{
+    uint64_t value = 0;
+    for (size_t i = lo + count; i-- > lo;) value = value * 10 + bcd_get_digit(x, i);
+    return value;
+}
+
+// Leading divisor digits used to estimate each quotient digit
+#define BCD_DIV_ESTIMATE_DIGITS 17
+
+/**
+ * @brief Schoolbook long division q[0..na) = a / b, r[0..nb) = a mod b. b must be nonzero.
+ * Each quotient digit is estimated from the top 18 digits of the running remainder against
+ * the top 17 digits of b. The estimate is never low and at most one too high, so one
+ * subtraction of a precomputed multiple plus a rare add-back settles it. Each step only
+ * touches the n+1 digit window under b, so the cost is O(n*m) digits.
+ */
+static bool bcd_divmod_schoolbook(BcdArena *arena, unsigned long *q, unsigned long *r,
+                                  const unsigned long *a, size_t na, const unsigned long *b, size_t nb)
+{
+    size_t n = bcd_digit_length(b, nb);
+    size_t m = bcd_digit_length(a, na);
+    size_t nbw = bcd_significant_words(b, nb);
+    memset(q, 0, na * sizeof(unsigned long));
+    memset(r, 0, nb * sizeof(unsigned long));
+    if (m < n) { // Quotient 0, remainder a (which then fits in b's words)
+        memcpy(r, a, bcd_significant_words(a, na) * sizeof(unsigned long));
+        return true;
+    }
+
+    // Running remainder has room for the window's top digit at position m
+    size_t mark = bcd_arena_mark(arena);
+    unsigned long *work = BCD_ARENA_WORDS(arena, na + 1, true);
+    // 1x..9x multiples of b, nbw + 1 words each (the extra word takes the carry digit)
+    unsigned long *multiples = work ? BCD_ARENA_WORDS(arena, 10 * (nbw + 1), true) : NULL;
+    if (!multiples) {
+        bcd_arena_release(arena, mark);
+        return false;
+    }
+    memcpy(work, a, na * sizeof(unsigned long));
+    for (unsigned d = 1; d <= 9; d++) {
+        bcd_add_words(multiples + d * (nbw + 1), nbw + 1, multiples + (d - 1) * (nbw + 1), nbw + 1, b, nbw);
+    }
+
+    size_t skip = (n > BCD_DIV_ESTIMATE_DIGITS) ? n - BCD_DIV_ESTIMATE_DIGITS : 0;
+    uint64_t b_top = bcd_read_digits(b, skip, n - skip);
+
+    for (size_t j = m - n + 1; j-- > 0;) {
+        // The remainder is below b * 10^(j+1), so digits above j + n are zero
+        uint64_t r_top = bcd_read_digits(work, j + skip, n - skip + 1);
+        unsigned digit = (unsigned)(r_top / b_top);
+        if (digit > 9) digit = 9;
+        if (digit == 0) continue;
+
+        size_t lo = j / BCD_DIGITS_PER_WORD;
+        size_t window = (j + n) / BCD_DIGITS_PER_WORD - lo + 1;
+        unsigned shift = (unsigned)(j % BCD_DIGITS_PER_WORD);
+        unsigned long borrow = bcd_sub_shifted(work + lo, window, multiples + digit * (nbw + 1), nbw + 1, shift);
+        while (borrow) { // Estimate was one too high: add b back
+            digit--;
+            borrow = !bcd_add_shifted(work + lo, window, b, nbw, shift);
+        }
+        q[j / BCD_DIGITS_PER_WORD] |= (unsigned long)digit << (4 * (j % BCD_DIGITS_PER_WORD));
+    }
+
+    memcpy(r, work, nbw * sizeof(unsigned long));
+    bcd_arena_release(arena, mark);
+    return true;
+}
+
+// --- Newton reciprocal division ---
+// Used when both the divisor and the quotient have at least this many digits
+#define BCD_DEFAULT_NEWTON_THRESHOLD 8000
+
+static atomic_size_t bcd_newton_threshold = BCD_DEFAULT_NEWTON_THRESHOLD;
+
+/**
+ * @brief Sets the size (in digits) from which division switches from schoolbook to the Newton
+ * reciprocal method. Both the divisor and the quotient must reach it. Values below two
+ * estimate windows are clamped.
+ */
+void bcd_set_newton_threshold(size_t digits)
+{
+    if (digits < 2 * BCD_DIV_ESTIMATE_DIGITS) digits = 2 * BCD_DIV_ESTIMATE_DIGITS;
+    atomic_store_explicit(&bcd_newton_threshold, digits, memory_order_relaxed);
+}
+
+size_t bcd_get_newton_threshold(void)
+{
+    return atomic_load_explicit(&bcd_newton_threshold, memory_order_relaxed);
+}
+
+// r[0..n) = 10^digits
+static void bcd_power_of_ten(unsigned long *r, size_t n, size_t digits)
+{
+    memset(r, 0, n * sizeof(unsigned long));
+    r[digits / BCD_DIGITS_PER_WORD] = 1UL << (4 * (digits % BCD_DIGITS_PER_WORD));
+}
+
+/**
+ * @brief x[0..BCD_WORDS_FOR_DIGITS(t + 2)) = floor(10^2t / d) for a t-digit d (top digit nonzero).
+ * Recurses on the top half of d, takes one Newton step
+ * Y = 2 * X_h * 10^(t-h) - floor(d * X_h^2 / 10^2h) on the fast multiply path and then
+ * settles the last units against 10^2t, so every level returns the exact floor.
+ */
+static bool bcd_reciprocal_words(BcdArena *arena, unsigned long *x, const unsigned long *d, size_t t)
+{
+    size_t nx = BCD_WORDS_FOR_DIGITS(t + 2);
+    size_t nd = BCD_WORDS_FOR_DIGITS(t);
+    size_t np = BCD_WORDS_FOR_DIGITS(2 * t + 2); // 10^2t and d * Y
+    memset(x, 0, nx * sizeof(unsigned long));
+    size_t mark = bcd_arena_mark(arena);
+
+    if (t <= 2 * BCD_DIV_ESTIMATE_DIGITS) { // Small: one schoolbook division
+        unsigned long *power = BCD_ARENA_WORDS(arena, 2 * np + nd, true);
+        if (!power) return false;
+        bcd_power_of_ten(power, np, 2 * t);
+        bool ok = bcd_divmod_schoolbook(arena, power + np, power + 2 * np, power, np, d, nd);
+        if (ok) memcpy(x, power + np, nx * sizeof(unsigned long));
+        bcd_arena_release(arena, mark);
+        return ok;
+    }
+
+    size_t h = (t + 1) / 2;
+    size_t nh = BCD_WORDS_FOR_DIGITS(h);
+    size_t nxh = BCD_WORDS_FOR_DIGITS(h + 2);
+    size_t nsq = 2 * nxh;           // X_h^2
+    size_t nprod = nd + nsq;        // d * X_h^2
+    size_t total = nh + nxh + nsq + nprod + 4 * np;
+    unsigned long *buf = BCD_ARENA_WORDS(arena, total, true);
+    if (!buf) return false;
+    unsigned long *d_top = buf, *xh = d_top + nh, *sq = xh + nxh, *prod = sq + nsq;
+    unsigned long *y = prod + nprod, *twice = y + np, *power = twice + np, *d_wide = power + np;
+
+    bcd_shift_words_down(d_top, nh, d, nd, 4 * (t - h));
+    bool ok = bcd_reciprocal_words(arena, xh, d_top, h) &&
+              bcd_mul_words(arena, sq, xh, nxh, xh, nxh) &&
+              bcd_mul_words(arena, prod, d, nd, sq, nsq);
+    if (ok) {
+        // Y = 2 * X_h * 10^(t-h) - floor(d * X_h^2 / 10^2h)
+        bcd_shift_words_up(twice, np, xh, nxh, 4 * (t - h));
+        bcd_add_n(twice, twice, twice, np, 0);
+        bcd_shift_words_down(y, np, prod, nprod, 4 * (2 * h));
+        bcd_sub_n(y, twice, y, np, 0);
+
+        // Settle Y = floor(10^2t / d): keep d * Y <= 10^2t < d * (Y + 1)
+        unsigned long *dy = twice;
+        bcd_power_of_ten(power, np, 2 * t);
+        memcpy(d_wide, d, nd * sizeof(unsigned long));
+        memset(prod, 0, nprod * sizeof(unsigned long));
+        ok = bcd_mul_words(arena, prod, y, nx, d, nd);
+        if (ok) {
+            memset(dy, 0, np * sizeof(unsigned long));
+            memcpy(dy, prod, ((nx + nd < np) ? nx + nd : np) * sizeof(unsigned long));
+            while (bcd_compare_words(dy, power, np) > 0) {
+                bcd_decrement_n(y, np, 1);
+                bcd_sub_in_place(dy, np, d, nd);
+            }
+            bcd_sub_in_place(power, np, dy, np); // 10^2t - d * Y
+            while (bcd_compare_words(power, d_wide, np) >= 0) {
+                bcd_increment_n(y, np, 1);
+                bcd_sub_in_place(power, np, d, nd);
+            }
+            memcpy(x, y, nx * sizeof(unsigned long));
+        }
+    }
+    bcd_arena_release(arena, mark);
+    return ok;
+}
+
+/**
+ * @brief Divide-by-reciprocal for large operands, same contract as bcd_divmod_schoolbook.
+ * With k quotient digits both operands are scaled by 10^(t-n) so the divisor has t = k + 2
+ * digits (dropping low divisor digits or appending zeros). Then
+ * q = floor(a_t * floor(10^2t / b_t) / 10^2t) is within a unit or two of the true quotient,
+ * and one multiply-back settles it. Cost is a few multiplications of k-digit numbers
+ * instead of k * n digit steps.
+ */
+static bool bcd_divmod_newton(BcdArena *arena, unsigned long *q, unsigned long *r,
+                              const unsigned long *a, size_t na, const unsigned long *b, size_t nb)
+{
+    size_t n = bcd_digit_length(b, nb);
+    size_t m = bcd_digit_length(a, na);
+    size_t nbw = bcd_significant_words(b, nb);
+    size_t k = m - n + 1;
+    size_t t = k + 2; // Reciprocal precision: a couple of digits beyond the quotient
+
+    size_t nt = BCD_WORDS_FOR_DIGITS(t);
+    size_t nx = BCD_WORDS_FOR_DIGITS(t + 2);
+    size_t nat = BCD_WORDS_FOR_DIGITS(k + t - 1);
+    size_t nq = BCD_WORDS_FOR_DIGITS(k + 2);
+    size_t wide = ((nq + nbw > na) ? nq + nbw : na) + 1; // Room for q * b and a side by side
+    size_t total = nt + nx + nat + (nat + nx) + nq + 2 * wide;
+    size_t mark = bcd_arena_mark(arena);
+    unsigned long *buf = BCD_ARENA_WORDS(arena, total, true);
+    if (!buf) return false;
+    unsigned long *b_top = buf, *x = b_top + nt, *a_top = x + nx, *prod = a_top + nat;
+    unsigned long *q_hat = prod + nat + nx, *qb = q_hat + nq, *rem = qb + wide;
+
+    if (n >= t) { // Scale both operands so the divisor has exactly t digits
+        bcd_shift_words_down(b_top, nt, b, nbw, 4 * (n - t));
+        bcd_shift_words_down(a_top, nat, a, na, 4 * (n - t));
+    } else {
+        bcd_shift_words_up(b_top, nt, b, nbw, 4 * (t - n));
+        bcd_shift_words_up(a_top, nat, a, na, 4 * (t - n));
+    }
+    bool ok = bcd_reciprocal_words(arena, x, b_top, t) &&
+              bcd_mul_words(arena, prod, a_top, nat, x, nx);
+    if (ok) {
+        bcd_shift_words_down(q_hat, nq, prod, nat + nx, 4 * (2 * t));
+        ok = bcd_mul_words(arena, qb, q_hat, nq, b, nbw);
+    }
+    if (ok) {
+        // Settle q_hat: q_hat * b <= a < (q_hat + 1) * b
+        memcpy(rem, a, na * sizeof(unsigned long));
+        while (bcd_compare_words(qb, rem, wide) > 0) {
+            bcd_decrement_n(q_hat, nq, 1);
+            bcd_sub_in_place(qb, wide, b, nbw);
+        }
+        bcd_sub_in_place(rem, wide, qb, wide);
+        memset(qb, 0, wide * sizeof(unsigned long)); // Reused as b widened for the compare
+        memcpy(qb, b, nbw * sizeof(unsigned long));
+        while (bcd_compare_words(rem, qb, wide) >= 0) {
+            bcd_increment_n(q_hat, nq, 1);
+            bcd_sub_in_place(rem, wide, b, nbw);
+        }
+        memset(q, 0, na * sizeof(unsigned long));
+        memcpy(q, q_hat, ((nq < na) ? nq : na) * sizeof(unsigned long));
+        memset(r, 0, nb * sizeof(unsigned long));
+        memcpy(r, rem, nbw * sizeof(unsigned long));
+    }
+    bcd_arena_release(arena, mark);
+    return ok;
+}
+
+// Largest divisor length (digits) that always fits a uint32_t
+#define BCD_SMALL_DIVISOR_DIGITS 9
+
+/**
+ * @brief Picks the division method: a single linear pass when the divisor fits a machine word,
+ * Newton once both divisor and quotient are long, else schoolbook.
+ */
+static bool bcd_divmod_words(BcdArena *arena, unsigned long *q, unsigned long *r,
+                             const unsigned long *a, size_t na, const unsigned long *b, size_t nb)
+{
+    size_t n = bcd_digit_length(b, nb);
+    size_t m = bcd_digit_length(a, na);
+    if (n <= BCD_SMALL_DIVISOR_DIGITS) {
+        uint32_t rem = bcd_divmod_small_words(q, a, na, (uint32_t)bcd_read_digits(b, 0, n));
+        memset(r, 0, nb * sizeof(unsigned long));
+        for (size_t i = 0; rem != 0; i++, rem /= 10) {
+            r[i / BCD_DIGITS_PER_WORD] |= (unsigned long)(rem % 10) << (4 * (i % BCD_DIGITS_PER_WORD));
+        }
+        return true;
+    }
+    size_t newton = bcd_get_newton_threshold();
+    if (m >= n && n >= newton && m - n + 1 >= newton) {
+        return bcd_divmod_newton(arena, q, r, a, na, b, nb);
+    }
+    return bcd_divmod_schoolbook(arena, q, r, a, na, b, nb);
+}
+
+/**
+ * @brief Long division of magnitudes. Returns |a| / |b| (truncated) and, when remainder is
+ * not NULL, stores |a| mod |b| there. Both results are positive; callers trim.
+ * Returns NULL on division by zero or allocation failure.
+ */
+Bitset *bcd_divmod_magnitude(const Bitset *a, const Bitset *b, Bitset **remainder)
+{
+    return bcd_divmod_magnitude_ex(a, b, remainder, NULL);
+}
+
+Bitset *bcd_divmod_magnitude_ex(const Bitset *a, const Bitset *b, Bitset **remainder, BcdArena *arena)
+{
+    if (remainder) *remainder = NULL;
+    if (!a || !b) {
+        fprintf(stderr, "Error: NULL parameter passed to bcd_divmod_magnitude.\n");
+        return NULL;
+    }
+    if (bitset_is_zero(b)) {
+        fprintf(stderr, "Error: Division by zero.\n");
+        return NULL;
+    }
+
+    size_t size_a = ((a->size + 3) / 4) * 4; if (size_a == 0) size_a = 4;
+    size_t size_b = ((b->size + 3) / 4) * 4; if (size_b == 0) size_b = 4;
+    Bitset *quotient = bitset_create(size_a);
+    Bitset *rem = bitset_create(size_b);
+    if (!quotient || !rem) { bitset_free(quotient); bitset_free(rem); return NULL; }
+
+    size_t na = BCD_WORDS_FOR_BITS(a->size);
+    size_t nb = BCD_WORDS_FOR_BITS(b->size);
+    if (na > 0) {
+        size_t mark;
+        BcdArena *scratch = bcd_scratch_open(arena, 4 * (na + nb) * sizeof(unsigned long), &mark);
+        bool ok = scratch && bcd_divmod_words(scratch, quotient->data, rem->data, a->data, na, b->data, nb);
+        if (scratch) bcd_scratch_close(scratch, arena, mark);
+        if (!ok) {
+            bitset_free(quotient);
+            bitset_free(rem);
+            return NULL;
+        }
+    }
+
+    if (remainder) *remainder = rem; else bitset_free(rem);
+    return quotient;
+}
+
+/**
+ * @brief Signed division with truncation toward zero, as in C: the quotient is negative
+ * when the signs differ, the remainder takes the sign of a. Zero results are never negative.
+ */
+Bitset *bcd_divmod(const Bitset *a, const Bitset *b, Bitset **remainder)
+{
+    return bcd_divmod_ex(a, b, remainder, NULL);
+}
+
+Bitset *bcd_divmod_ex(const Bitset *a, const Bitset *b, Bitset **remainder, BcdArena *arena)
+{
+    Bitset *rem = NULL;
+    Bitset *quotient = bcd_divmod_magnitude_ex(a, b, remainder ? &rem : NULL, arena);
+    if (!quotient) return NULL;
+    quotient->is_negative = (a->is_negative != b->is_negative) && !bitset_is_zero(quotient);
+    if (remainder) {
+        rem->is_negative = a->is_negative && !bitset_is_zero(rem);
+        *remainder = rem;
+    }
+    return quotient;
+}
+
+Bitset *bcd_divide(const Bitset *a, const Bitset *b)
+{
+    return bcd_divmod(a, b, NULL);
+}
+
+Bitset *bcd_remainder(const Bitset *a, const Bitset *b)
+{
+    Bitset *rem = NULL;
+    Bitset *quotient = bcd_divmod(a, b, &rem);
+    bitset_free(quotient);
+    return rem;
+}
+
+/**
+ * @brief Divides by a machine integer in one MSB-to-LSB pass, eight digits per step.
+ * The quotient is truncated toward zero and keeps a's sign. When remainder is not NULL it
+ * receives |a| mod divisor. Returns NULL on division by zero or allocation failure.
+ */
+Bitset *bcd_divmod_uint32(const Bitset *a, uint32_t divisor, uint32_t *remainder)
+{
+    if (remainder) *remainder = 0;
+    if (!a) {
+        fprintf(stderr, "Error: NULL parameter passed to bcd_divmod_uint32.\n");
+        return NULL;
+    }
+    if (divisor == 0) {
+        fprintf(stderr, "Error: Division by zero.\n");
+        return NULL;
+    }
+
+    size_t size_a = ((a->size + 3) / 4) * 4; if (size_a == 0) size_a = 4;
+    Bitset *quotient = bitset_create(size_a);
+    if (!quotient) return NULL;
+    uint32_t rem = bcd_divmod_small_words(quotient->data, a->data, BCD_WORDS_FOR_BITS(a->size), divisor);
+    quotient->is_negative = a->is_negative && !bitset_is_zero(quotient);
+    if (remainder) *remainder = rem;
+    return quotient;
+}
+
+/**
+ * @brief |a| mod divisor without building a quotient. Returns 0 (and reports) on division by zero.
+ */
+uint32_t bcd_mod_uint32(const Bitset *a, uint32_t divisor)
+{
+    if (!a) {
+        fprintf(stderr, "Error: NULL parameter passed to bcd_mod_uint32.\n");
+        return 0;
+    }
+    if (divisor == 0) {
+        fprintf(stderr, "Error: Division by zero.\n");
+        return 0;
+    }
+    return bcd_divmod_small_words(NULL, a->data, BCD_WORDS_FOR_BITS(a->size), divisor);
+}
+
+// --- Signed arithmetic ---
+// The _into functions write dst = a op b, where dst may be a or b itself. dst keeps its
+// buffer and only grows (geometrically) when the result needs more room than it has.
+
+// Completes a result built in dst->data[0..n): clears what is left of the old value above
+// it, sets the sign and trims, which also makes zero positive
+static void bcd_finish_result(Bitset *dst, size_t n, size_t old_words, bool negative)
+{
+    if (old_words > n) memset(dst->data + n, 0, (old_words - n) * sizeof(unsigned long));
+    dst->size = n * BITSET_WORD_SIZE;
+    dst->is_negative = negative;
+    dst->digits = BITSET_DIGITS_UNKNOWN;
+    bitset_normalize(dst);
+}
+
+/**
+ * @brief dst = a + b, or a - b when negate_b, straight from the operands' significant words.
+ * Equal effective signs add the magnitudes; otherwise the smaller magnitude is subtracted
+ * from the larger. No operand is copied or sign-flipped.
+ */
+static bool bcd_add_signed_into(Bitset *dst, const Bitset *a, const Bitset *b, bool negate_b,
+                                const char *name)
+{
+    if (!dst || !a || !b) {
+        fprintf(stderr, "Error: NULL parameter passed to %s.\n", name);
+        return false;
+    }
+    // Read everything about the operands before dst (possibly one of them) changes
+    bool a_negative = a->is_negative;
+    bool b_negative = (b->is_negative != negate_b);
+    size_t da = bitset_digit_length(a), db = bitset_digit_length(b);
+    size_t na = BCD_WORDS_FOR_DIGITS(da), nb = BCD_WORDS_FOR_DIGITS(db);
+    size_t old_words = BCD_WORDS_FOR_BITS(dst->size);
+
+    size_t n = BCD_WORDS_FOR_DIGITS((da > db ? da : db) + 1); // Room for a carry digit
+    if (!bitset_reserve(dst, n * BITSET_WORD_SIZE)) return false;
+    unsigned long *r = dst->data;
+
+    bool negative;
+    if (a_negative == b_negative) {
+        bcd_add_words(r, n, a->data, na, b->data, nb);
+        negative = a_negative;
+    } else {
+        int cmp = (da != db) ? ((da > db) ? 1 : -1) : bcd_compare_words(a->data, b->data, na);
+        const unsigned long *larger = (cmp >= 0) ? a->data : b->data;
+        const unsigned long *smaller = (cmp >= 0) ? b->data : a->data;
+        size_t nl = (cmp >= 0) ? na : nb, ns = (cmp >= 0) ? nb : na;
+        unsigned long borrow = bcd_sub_n(r, larger, smaller, ns, 0);
+        if (r != larger) memcpy(r + ns, larger + ns, (nl - ns) * sizeof(unsigned long));
+        bcd_decrement_n(r + ns, nl - ns, borrow); // |larger| >= |smaller|: no borrow out
+        memset(r + nl, 0, (n - nl) * sizeof(unsigned long));
+        negative = (cmp >= 0) ? a_negative : b_negative;
+    }
+    bcd_finish_result(dst, n, old_words, negative);
+    return true;
+}
+
+bool bcd_add_into(Bitset *dst, const Bitset *a, const Bitset *b)
+{
+    return bcd_add_signed_into(dst, a, b, false, "bcd_add_into");
+}
+
+bool bcd_sub_into(Bitset *dst, const Bitset *a, const Bitset *b)
+{
+    return bcd_add_signed_into(dst, a, b, true, "bcd_sub_into");
+}
+
+/**
+ * @brief dst = a * b, signed. When dst is neither operand the product is built in dst's own
+ * buffer; otherwise it goes through scratch first, as the kernels need a separate output.
+ */
+bool bcd_mul_into(Bitset *dst, const Bitset *a, const Bitset *b)
+{
+    if (!dst || !a || !b) {
+        fprintf(stderr, "Error: NULL parameter passed to bcd_mul_into.\n");
+        return false;
+    }
+    bool negative = (a->is_negative != b->is_negative);
+    size_t da = bitset_digit_length(a), db = bitset_digit_length(b);
+    size_t na = BCD_WORDS_FOR_DIGITS(da), nb = BCD_WORDS_FOR_DIGITS(db);
+    size_t old_words = BCD_WORDS_FOR_BITS(dst->size);
+    if (da == 0 || db == 0) { // Zero shortcut
+        bcd_finish_result(dst, 0, old_words, false);
+        return true;
+    }
+    bool square = (a == b) || (da == db && bcd_compare_words(a->data, b->data, na) == 0);
+    bool aliased = (dst == a || dst == b);
+
+    size_t n = na + nb, mark;
+    if (!bitset_reserve(dst, n * BITSET_WORD_SIZE)) return false;
+    BcdArena *scratch = bcd_scratch_open(NULL, 4 * n * sizeof(unsigned long), &mark);
+    unsigned long *r = !scratch ? NULL : aliased ? BCD_ARENA_WORDS(scratch, n, false) : dst->data;
+    bool ok = r && (square ? bcd_mul_words(scratch, r, a->data, na, a->data, na)
+                           : bcd_mul_words(scratch, r, a->data, na, b->data, nb));
+    if (ok && r != dst->data) memcpy(dst->data, r, n * sizeof(unsigned long));
+    if (scratch) bcd_scratch_close(scratch, NULL, mark);
+    if (!ok) {
+        fprintf(stderr, "Error: bcd_mul_into failed to allocate scratch.\n");
+        return false;
+    }
+    bcd_finish_result(dst, n, old_words, negative);
+    return true;
+}
+
+bool bcd_add_assign(Bitset *acc, const Bitset *b)
+{
+    return bcd_add_into(acc, acc, b);
+}
+
+bool bcd_sub_assign(Bitset *acc, const Bitset *b)
+{
+    return bcd_sub_into(acc, acc, b);
+}
+
+bool bcd_mul_assign(Bitset *acc, const Bitset *b)
+{
+    return bcd_mul_into(acc, acc, b);
+}
+
+/**
+ * @brief acc *= digit (0..9) in one pass over acc's words, growing by at most one digit.
+ */
+bool bcd_mul_digit_assign(Bitset *acc, unsigned digit)
+{
+    if (!acc || digit > 9) {
+        fprintf(stderr, "Error: bcd_mul_digit_assign needs a Bitset and a digit 0..9.\n");
+        return false;
+    }
+    size_t digits = bitset_digit_length(acc);
+    size_t n = BCD_WORDS_FOR_DIGITS(digits);
+    size_t old_words = BCD_WORDS_FOR_BITS(acc->size);
+    if (!bitset_reserve(acc, (n + 1) * BITSET_WORD_SIZE)) return false;
+    unsigned long carry = 0;
+    for (size_t w = 0; w < n; w++) acc->data[w] = bcd_word_mul_digit(acc->data[w], digit, &carry);
+    acc->data[n] = carry; // Nonzero only when the top word was full
+    bcd_finish_result(acc, n + 1, old_words, acc->is_negative);
+    return true;
+}
+
+/**
+ * @brief acc += a * b, signed, without a product Bitset.
+ * Below the Karatsuba cutoff the schoolbook partial products are added into (or, when the
+ * product's sign differs from acc's, subtracted from) acc's own words. Larger products are
+ * formed in scratch and then added or subtracted in one pass. A borrow out of the top means
+ * the product outweighed acc: the words then hold 10^k - |result|, so a ten's complement
+ * recovers the magnitude and acc's sign flips.
+ */
+bool bcd_fma(Bitset *acc, const Bitset *a, const Bitset *b)
+{
+    if (!acc || !a || !b) {
+        fprintf(stderr, "Error: NULL parameter passed to bcd_fma.\n");
+        return false;
+    }
+    size_t da = bitset_digit_length(a), db = bitset_digit_length(b);
+    if (da == 0 || db == 0) { // Adds zero
+        bitset_normalize(acc);
+        return true;
+    }
+    size_t dacc = bitset_digit_length(acc);
+    bool product_negative = (a->is_negative != b->is_negative);
+    bool subtract = (dacc != 0) && (product_negative != acc->is_negative);
+    bool negative = (dacc != 0) ? acc->is_negative : product_negative;
+
+    size_t na = BCD_WORDS_FOR_DIGITS(da), nb = BCD_WORDS_FOR_DIGITS(db);
+    size_t nacc = BCD_WORDS_FOR_DIGITS(dacc);
+    size_t n = ((nacc > na + nb) ? nacc : na + nb) + 1; // Room for the carry of an add
+    size_t old_words = BCD_WORDS_FOR_BITS(acc->size);
+    // Words of acc above its digits are zero up to capacity, so acc->data[0..n) is |acc|
+    if (!bitset_reserve(acc, n * BITSET_WORD_SIZE)) return false;
+
+    bool square = (a == b) || (da == db && bcd_compare_words(a->data, b->data, na) == 0);
+    bool fused = (acc != a && acc != b) && // acc must not change under the operands
+                 ((na < nb) ? na : nb) < bcd_get_karatsuba_threshold() / BCD_DIGITS_PER_WORD;
+    size_t mark;
+    BcdArena *scratch = bcd_scratch_open(NULL, 4 * (na + nb) * sizeof(unsigned long), &mark);
+    unsigned long out = 0;
+    bool ok = false;
+    if (scratch && fused) {
+        ok = bcd_mul_accumulate(scratch, acc->data, n, a->data, na, b->data, nb, subtract, &out);
+    } else if (scratch) {
+        unsigned long *product = BCD_ARENA_WORDS(scratch, na + nb, false);
+        ok = product && (square ? bcd_mul_words(scratch, product, a->data, na, a->data, na)
+                                : bcd_mul_words(scratch, product, a->data, na, b->data, nb));
+        if (ok) out = subtract ? bcd_sub_shifted(acc->data, n, product, na + nb, 0)
+                               : bcd_add_shifted(acc->data, n, product, na + nb, 0);
+    }
+    if (scratch) bcd_scratch_close(scratch, NULL, mark);
+    if (!ok) {
+        fprintf(stderr, "Error: bcd_fma failed to allocate scratch.\n");
+        return false;
+    }
+
+    if (subtract && out) { // Ten's complement: nines complement, then add one
+        bcd_nines_complement(acc->data, acc->data, n * BITSET_WORD_SIZE);
+        bcd_increment_n(acc->data, n, 1);
+        negative = !negative;
+    }
+    bcd_finish_result(acc, n, old_words, negative);
+    return true;
+}
+
+// New Bitset sized up front for digits digits, so the _into call below does not reallocate
+static Bitset *bcd_new_result(bool (*into)(Bitset *, const Bitset *, const Bitset *),
+                              const Bitset *a, const Bitset *b, size_t digits)
+{
+    Bitset *result = bitset_create((digits ? digits : 1) * 4);
+    if (result && !into(result, a, b)) {
+        bitset_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+/**
+ * @brief Signed a + b as a new normalized Bitset. NULL on bad input or allocation failure.
+ */
+Bitset *bcd_add(const Bitset *a, const Bitset *b)
+{
+    size_t da = bitset_digit_length(a), db = bitset_digit_length(b);
+    return bcd_new_result(bcd_add_into, a, b, (da > db ? da : db) + 1);
+}
+
+/**
+ * @brief Signed a - b as a new normalized Bitset. NULL on bad input or allocation failure.
+ */
+Bitset *bcd_sub(const Bitset *a, const Bitset *b)
+{
+    size_t da = bitset_digit_length(a), db = bitset_digit_length(b);
+    return bcd_new_result(bcd_sub_into, a, b, (da > db ? da : db) + 1);
+}
+
+/**
+ * @brief Signed a * b as a new normalized Bitset (zero is never negative).
+ */
+Bitset *bcd_mul(const Bitset *a, const Bitset *b)
+{
+    size_t words = BCD_WORDS_FOR_DIGITS(bitset_digit_length(a)) + BCD_WORDS_FOR_DIGITS(bitset_digit_length(b));
+    return bcd_new_result(bcd_mul_into, a, b, words * BCD_DIGITS_PER_WORD); // Whole words, as the kernels write
+}
+
+// --- Multi-operand summation ---
+// bcd_sum adds every value's digits into unnormalized counters instead of a BCD total.
+// A counter first lives in a byte, which absorbs 28 values (28 * 9 = 252), then in a 16-bit
+// lane, which absorbs 260 such byte flushes; decimal carries are resolved only after that.
+// Adding a value is two masked word adds per word (bcd_sum_column), with no +6 correction
+// or carry chain.
+#define BCD_SUM_HALF_LANES (~0UL / 0xFFFFUL * 0xFFUL) // 0x00FF...00FF
+#define BCD_SUM_BYTE_ROUNDS 28  // Values per byte flush
+#define BCD_SUM_HALF_ROUNDS 260 // Byte flushes per normalization
+
+// Counters of one sign, in planes of width words so each pass is a straight stream.
+// Digit j of word w sits in byte j >> 1 of plane j & 1 of bytes, and after a flush in
+// 16-bit lane j >> 2 of plane 2(j & 1) + ((j >> 1) & 1) of halves.
+typedef struct
+{
+    unsigned long *bytes;  // 2 planes: even digits, odd digits
+    unsigned long *halves; // 4 planes
+    unsigned long *total;  // Normalized sum of everything flushed so far
+    size_t width;          // Words per plane
+    size_t words;          // BCD words touched since the last normalization
+    unsigned byte_rounds, half_rounds;
+} BcdSumLanes;
+
+static void bcd_sum_flush_bytes(BcdSumLanes *s)
+{
+    for (size_t p = 0; p < 2; p++) {
+        unsigned long *bytes = s->bytes + p * s->width;
+        unsigned long *low = s->halves + 2 * p * s->width, *high = low + s->width;
+        for (size_t w = 0; w < s->words; w++) {
+            low[w] += bytes[w] & BCD_SUM_HALF_LANES;
+            high[w] += (bytes[w] >> 8) & BCD_SUM_HALF_LANES;
+            bytes[w] = 0;
+        }
+    }
+    s->byte_rounds = 0;
+    s->half_rounds++;
+}
+
+// Resolves the 16-bit counters into total[0..total_words) one digit at a time and clears them
+static void bcd_sum_normalize(BcdSumLanes *s, size_t total_words)
+{
+    uint64_t carry = 0;
+    for (size_t w = 0; w < total_words && (w < s->words || carry); w++) {
+        unsigned long out = 0;
+        for (unsigned j = 0; j < BCD_DIGITS_PER_WORD; j++) {
+            uint64_t v = carry + ((s->total[w] >> (4 * j)) & 0xFUL);
+            size_t plane = 2 * (j & 1) + ((j >> 1) & 1);
+            if (w < s->words) v += (s->halves[plane * s->width + w] >> (16 * (j >> 2))) & 0xFFFFUL;
+            out |= (unsigned long)(v % 10) << (4 * j);
+            carry = v / 10;
+        }
+        s->total[w] = out;
+    }
+    for (size_t plane = 0; plane < 4; plane++) {
+        memset(s->halves + plane * s->width, 0, s->words * sizeof(unsigned long));
+    }
+    s->half_rounds = 0;
+}
+
+/**
+ * @brief Signed sum of values[0..n) as a new normalized Bitset (zero for n == 0).
+ * Positive and negative values go to separate counters, so no value is ever subtracted;
+ * the two totals meet in one subtraction at the end. NULL on bad input or allocation failure.
+ */
+Bitset *bcd_sum(const Bitset *const *values, size_t n)
+{
+    if (!values && n > 0) {
+        fprintf(stderr, "Error: NULL parameter passed to bcd_sum.\n");
+        return NULL;
+    }
+    size_t width = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!values[i]) {
+            fprintf(stderr, "Error: NULL value %zu passed to bcd_sum.\n", i);
+            return NULL;
+        }
+        size_t words = BCD_WORDS_FOR_DIGITS(bitset_digit_length(values[i]));
+        if (words > width) width = words;
+    }
+    size_t total_words = width + 2; // Carries of up to 10^(2 * BCD_DIGITS_PER_WORD) values
+
+    size_t mark;
+    BcdArena *scratch = bcd_scratch_open(NULL, 2 * (6 * width + total_words) * sizeof(unsigned long), &mark);
+    BcdSumLanes lanes[2] = {{0}}; // [0]: positive values, [1]: negative values
+    bool ok = scratch != NULL;
+    for (int k = 0; k < 2 && ok; k++) {
+        lanes[k].bytes = BCD_ARENA_WORDS(scratch, 6 * width + total_words, true);
+        ok = lanes[k].bytes != NULL;
+        if (ok) {
+            lanes[k].halves = lanes[k].bytes + 2 * width;
+            lanes[k].total = lanes[k].halves + 4 * width;
+            lanes[k].width = width;
+        }
+    }
+    Bitset *result = ok ? bitset_create(total_words * BITSET_WORD_SIZE) : NULL;
+    if (!result) {
+        if (scratch) bcd_scratch_close(scratch, NULL, mark);
+        fprintf(stderr, "Error: bcd_sum failed to allocate its counters.\n");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const unsigned long *x = values[i]->data;
+        size_t words = BCD_WORDS_FOR_DIGITS(bitset_digit_length(values[i]));
+        BcdSumLanes *s = &lanes[values[i]->is_negative ? 1 : 0];
+        bcd_sum_column(s->bytes, s->bytes + width, x, words);
+        if (words > s->words) s->words = words;
+        if (++s->byte_rounds == BCD_SUM_BYTE_ROUNDS) {
+            bcd_sum_flush_bytes(s);
+            if (s->half_rounds == BCD_SUM_HALF_ROUNDS) bcd_sum_normalize(s, total_words);
+        }
+    }
+    for (int k = 0; k < 2; k++) {
+        bcd_sum_flush_bytes(&lanes[k]);
+        bcd_sum_normalize(&lanes[k], total_words);
+    }
+
+    // |positive| - |negative|, larger minus smaller
+    const unsigned long *pos = lanes[0].total, *neg = lanes[1].total;
+    int cmp = bcd_compare_words(pos, neg, total_words);
+    bcd_sub_n(result->data, (cmp >= 0) ? pos : neg, (cmp >= 0) ? neg : pos, total_words, 0);
+    bcd_scratch_close(scratch, NULL, mark);
+    result->is_negative = (cmp < 0);
+    result->digits = BITSET_DIGITS_UNKNOWN;
+    bitset_normalize(result);
+    return result;
+}
+
+/**
+ * @brief Drops leading zero BCD digits in place (zero becomes a single positive "0000").
+ * Only size shrinks; the words stay allocated as spare capacity.
+ */
+void bitset_normalize(Bitset *bitset)
+{
+    if (!bitset) return;
+    size_t digits = bitset_digit_length(bitset);
+    if (digits == 0) bitset->is_negative = false; // Zero is not negative
+    bitset_resize_in_place(bitset, (digits == 0 ? 1 : digits) * 4); // Shrinks, or grows tiny sizes to one digit
+    bitset->digits = digits;
+}
+
+/**
+ * @brief Creates a new bitset by removing leading zero BCD digits.
+ */
+Bitset *bitset_trim_leading_zeros(const Bitset *original) {
+    if (!original) return NULL;
+    size_t digits = bitset_digit_length(original);
+    size_t new_size = (digits == 0 ? 1 : digits) * 4; // Zero is represented as "0000"
+
+    Bitset *trimmed = bitset_create(new_size);
+    if (!trimmed) return NULL;
+    trimmed->is_negative = (digits != 0) ? original->is_negative : false;
+    if (digits != 0) memcpy(trimmed->data, original->data, BCD_WORDS_FOR_DIGITS(digits) * sizeof(unsigned long));
+    trimmed->digits = digits;
+    return trimmed;
+}
+
+/**
+ * @brief Checks if a bitset represents the value zero.
+ */
+bool bitset_is_zero(const Bitset *bs) {
+    if (!bs) return false; // Treat NULL as non-zero
+    // Efficient check: iterate through data words
+    size_t num_words = (bs->size + BITSET_WORD_SIZE - 1) / BITSET_WORD_SIZE;
+    if (!bs->data && bs->size > 0) return false; // Data NULL but size > 0? Not zero.
+    if (!bs->data) return true; // NULL data and size 0 is zero
+
+    for (size_t i = 0; i < num_words; ++i) {
+        unsigned long word = bs->data[i];
+        // Mask off bits beyond bs->size in the last word
+        if (i == num_words - 1 && bs->size % BITSET_WORD_SIZE != 0) {
+            size_t bits_in_last = bs->size % BITSET_WORD_SIZE;
+            unsigned long mask = (1UL << bits_in_last) - 1;
+            word &= mask;
+        }
+        if (word != 0) {
+            return false; // Found non-zero word (within size)
+        }
+    }
+    return true; // All relevant words/bits are zero
+}
+
+// <<< NEW FUNCTION DEFINITION: Creates a BCD string with spaces >>>
+char *bitset_to_string_grouped_bcd(const Bitset *bitset) {
+    if (!bitset || bitset->size == 0) {
+        // Return a default "0000" if input is empty or NULL
+        char *zero_str = (char *)malloc(5);
+        if (zero_str) strcpy(zero_str, "0000"); else return NULL;
+        return zero_str;
+    }
+    // Ensure size is at least 4 for BCD representation, pad if necessary conceptually for loop
+    size_t effective_size = (bitset->size < 4 && !bitset_is_zero(bitset)) ? 4 : bitset->size; // Make size at least 4 unless it's truly zero and already small
+    if (bitset->size > 0 && bitset->size < 4) effective_size = 4; // Force padding display for small non-zeros
+    if (bitset_is_zero(bitset) && bitset->size != 4) effective_size = 4; // Force "0000" if it's zero but wrong size
+
+    // Calculate size needed for string (bits + spaces + null)
+    size_t num_spaces = (effective_size > 0) ? (effective_size - 1) / 4 : 0;
+    size_t str_len = effective_size + num_spaces;
+    char *str = (char *)malloc(str_len + 1);
+    if (!str) return NULL;
+
+    if (effective_size == bitset->size && effective_size % 4 == 0) { // Whole digits: table copy + space
+        size_t digits = effective_size / 4;
+        for (size_t d = 0; d < digits; d++) {
+            size_t i = digits - 1 - d;
+            unsigned nibble = (unsigned)((bitset->data[i / BCD_DIGITS_PER_WORD] >> (4 * (i % BCD_DIGITS_PER_WORD))) & 0xFUL);
+            memcpy(str + 5 * d, bcd_nibble_bits[nibble], 4);
+            if (i > 0) str[5 * d + 4] = ' ';
+        }
+        str[str_len] = '\0';
+        return str;
+    }
+
+    size_t str_idx = 0;
+    // Iterate from MSB down to LSB (conceptually padding with '0' if effective_size > bitset->size)
+    for (long i = (long)effective_size - 1; i >= 0; --i) {
+        // Get bit value, defaulting to false (0) if beyond original bitset size
+        bool bit_val = ((size_t)i < bitset->size) ? bitset_test(bitset, i) : false;
+        str[str_idx++] = bit_val ? '1' : '0';
+
+        // Add space if we are not at the end AND the next bit starts a new group (index i is divisible by 4)
+        if (i > 0 && (i % 4 == 0)) {
+            str[str_idx++] = ' ';
+        }
+    }
+    str[str_idx] = '\0'; // Null terminate
+
+    return str;
+}
+
+
+// <<< NEW FUNCTION DEFINITION: Converts BCD magnitude to integer >>>
+long long bcd_to_int(const Bitset *bs) {
+    if (!bs) return -1; // Error: NULL input
+
+    long long result = 0;
+    long long power_of_10 = 1;
+
+    // Iterate through the bitset in 4-bit chunks (digits) from LSB to MSB
+    for (size_t i = 0; i < bs->size; i += 4) {
+        unsigned digit_value = 0;
+        // Extract the 4 bits for the current digit
+        for (size_t j = 0; j < 4; ++j) {
+            size_t current_bit_index = i + j;
+            if (current_bit_index < bs->size) { // Check bounds
+                if (bitset_test(bs, current_bit_index)) {
+                    digit_value |= (1 << j); // Build binary value of the 4 bits
+                }
+            }
+        }
+
+        // Check if the digit is valid BCD (0-9)
+        if (digit_value > 9) {
+            fprintf(stderr, "Warning: Invalid BCD digit detected (%u) during conversion to int.\n", digit_value);
+            // Return error
+            return -1;
+        }
+
+        // Add the digit's value times the appropriate power of 10
+        // Check for potential overflow *before* calculation
+        long long term;
+        if (__builtin_mul_overflow((long long)digit_value, power_of_10, &term)) { // Check multiplication overflow
+            fprintf(stderr, "Warning: Overflow calculating term in bcd_to_int.\n");
+            return -1;
+        }
+        if (__builtin_add_overflow(result, term, &result)) { // Check addition overflow
+            fprintf(stderr, "Warning: Overflow adding term in bcd_to_int.\n");
+            // Revert result? No easy way, just return error
+            return -1;
+        }
+
+        // Check power_of_10 for overflow *before* next multiplication
+        if (i + 4 < bs->size) { // Only check if there's a next digit
+            if (power_of_10 > LLONG_MAX / 10) {
+                fprintf(stderr, "Warning: Potential overflow multiplying power_of_10 in bcd_to_int.\n");
+                return -1;
+            }
+            power_of_10 *= 10;
+        }
+    }
+    return result;
+}
+
+// --- Decimal formatting ---
+
+// Spreads eight nibbles into the low halves of eight bytes (nibble i -> byte i)
+static uint64_t bcd_spread_nibbles(uint32_t nibbles)
+{
+#if defined(BCD_X86_DISPATCH) && defined(__BMI2__)
+    return _pdep_u64(nibbles, 0x0F0F0F0F0F0F0F0FULL);
+#else
+    uint64_t x = nibbles;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    return (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+#endif
+}
+
+// Writes eight packed digits as ASCII, most significant first, with one 8-byte store
+static void bcd_write8_digits(char *out, uint32_t nibbles)
+{
+    uint64_t ascii = bcd_spread_nibbles(nibbles);
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    ascii = __builtin_bswap64(ascii); // Most significant digit to the lowest address
+#endif
+    ascii |= 0x3030303030303030ULL;
+    memcpy(out, &ascii, sizeof(ascii));
+}
+
+/**
+ * @brief Formats a bitset as a decimal string ("-" for negative nonzero values, no leading
+ * zeros) into buf, snprintf style. Returns the length of the full string; it is written
+ * (with its terminator) only when buf_len is larger than that, so pass NULL / 0 to ask for
+ * the size. Whole words are expanded to ASCII eight digits per store.
+ */
+size_t bitset_format_decimal(const Bitset *bs, char *buf, size_t buf_len)
+{
+    if (!bs) return 0;
+    size_t n = bcd_significant_words(bs->data, BCD_WORDS_FOR_BITS(bs->size));
+    size_t digits = n ? bcd_digit_length(bs->data, n) : 1;
+    bool negative = bs->is_negative && n != 0;
+    size_t needed = digits + (negative ? 1 : 0);
+    if (!buf || buf_len <= needed) return needed;
+
+    char *out = buf;
+    if (negative) *out++ = '-';
+    if (n == 0) {
+        *out++ = '0';
+    } else {
+        // Partial top word digit by digit, then whole words
+        size_t top_digits = digits - (n - 1) * BCD_DIGITS_PER_WORD;
+        for (size_t i = top_digits; i-- > 0;) {
+            *out++ = (char)('0' + ((bs->data[n - 1] >> (4 * i)) & 0xFUL));
+        }
+        for (size_t w = n - 1; w-- > 0;) {
+            for (size_t c = BITSET_WORD_SIZE / 32; c-- > 0;) {
+                bcd_write8_digits(out, (uint32_t)(bs->data[w] >> (32 * c)));
+                out += 8;
+            }
+        }
+    }
+    *out = '\0';
+    return needed;
+}
+
+
+// --- Binary <-> BCD conversion ---
+// Little-endian uint32_t limb arrays. Both directions split the input in halves and
+// recombine with one multiply by a cached power of the other base, so the cost follows
+// multiplication instead of the quadratic digit-by-digit loops.
+#define BCD_BIN_KARATSUBA_LIMBS 32   // Binary multiply: schoolbook below this many limbs
+#define BCD_CONV_BASE_LIMBS 16       // Binary -> BCD: repeated division by 10^8 below this
+#define BCD_CONV_BASE_WORDS 8        // BCD -> binary: Horner in steps of 10^8 below this
+
+// Limbs enough for a value of `digits` decimal digits (each limb holds more than 9)
+#define BCD_LIMBS_FOR_DIGITS(digits) ((digits) / 9 + 2)
+// Words enough for a value of `limbs` limbs (each limb needs fewer than 10 digits)
+#define BCD_WORDS_FOR_LIMBS(limbs) BCD_WORDS_FOR_DIGITS(10 * (limbs) + 1)
+
+static size_t bcd_bin_significant(const uint32_t *x, size_t n)
+{
+    while (n > 0 && x[n - 1] == 0) n--;
+    return n;
+}
+
+// x[0..nx) += y[0..ny), nx >= ny; returns the carry out
+static uint32_t bcd_bin_add_in_place(uint32_t *x, size_t nx, const uint32_t *y, size_t ny)
+{
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < ny; i++) {
+        carry += (uint64_t)x[i] + y[i];
+        x[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    for (; i < nx && carry; i++) {
+        carry += x[i];
+        x[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    return (uint32_t)carry;
+}
+
+// x[0..nx) -= y[0..ny), nx >= ny, x >= y
+static void bcd_bin_sub_in_place(uint32_t *x, size_t nx, const uint32_t *y, size_t ny)
+{
+    int64_t borrow = 0;
+    size_t i = 0;
+    for (; i < ny; i++) {
+        int64_t diff = (int64_t)x[i] - y[i] + borrow;
+        x[i] = (uint32_t)diff;
+        borrow = diff >> 32; // 0 or -1
+    }
+    for (; i < nx && borrow; i++) {
+        int64_t diff = (int64_t)x[i] + borrow;
+        x[i] = (uint32_t)diff;
+        borrow = diff >> 32;
+    }
+}
+
+static void bcd_bin_mul_basecase(uint32_t *r, const uint32_t *a, size_t na, const uint32_t *b, size_t nb)
+{
+    memset(r, 0, (na + nb) * sizeof(uint32_t));
+    for (size_t i = 0; i < na; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < nb; j++) {
+            carry += (uint64_t)a[i] * b[j] + r[i + j];
+            r[i + j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        r[i + nb] = (uint32_t)carry;
+    }
+}
+
+/**
+ * @brief Binary product r[0..na+nb) = a * b: schoolbook for short operands, Karatsuba above
+ * BCD_BIN_KARATSUBA_LIMBS, slices for unbalanced operands. r must not overlap a or b.
+ */
+static bool bcd_bin_mul(BcdArena *arena, uint32_t *r, const uint32_t *a, size_t na, const uint32_t *b, size_t nb)
+{
+    if (na < nb) { const uint32_t *t = a; a = b; b = t; size_t tn = na; na = nb; nb = tn; }
+    if (nb < BCD_BIN_KARATSUBA_LIMBS) {
+        bcd_bin_mul_basecase(r, a, na, b, nb);
+        return true;
+    }
+
+    size_t h = (na + 1) / 2;
+    size_t mark = bcd_arena_mark(arena);
+    if (nb <= h) { // Unbalanced: a0 * b + a1 * b
+        uint32_t *part = BCD_ARENA_LIMBS(arena, na - h + nb, false);
+        bool ok = part && bcd_bin_mul(arena, r, a, h, b, nb) && bcd_bin_mul(arena, part, a + h, na - h, b, nb);
+        if (ok) {
+            memset(r + h + nb, 0, (na - h) * sizeof(uint32_t));
+            bcd_bin_add_in_place(r + h, na - h + nb, part, na - h + nb);
+        }
+        bcd_arena_release(arena, mark);
+        return ok;
+    }
+
+    // z0 = a0*b0 at r[0..2h), z2 = a1*b1 at r[2h..), middle (a0+a1)(b0+b1) - z0 - z2 at h
+    size_t n1a = na - h, n1b = nb - h;
+    uint32_t *buf = BCD_ARENA_LIMBS(arena, 4 * (h + 1), true);
+    if (!buf) return false;
+    uint32_t *sum_a = buf, *sum_b = buf + (h + 1), *middle = buf + 2 * (h + 1);
+    memcpy(sum_a, a, h * sizeof(uint32_t));
+    sum_a[h] = bcd_bin_add_in_place(sum_a, h, a + h, n1a);
+    memcpy(sum_b, b, h * sizeof(uint32_t));
+    sum_b[h] = bcd_bin_add_in_place(sum_b, h, b + h, n1b);
+
+    bool ok = bcd_bin_mul(arena, r, a, h, b, h) &&
+              bcd_bin_mul(arena, r + 2 * h, a + h, n1a, b + h, n1b) &&
+              bcd_bin_mul(arena, middle, sum_a, h + 1, sum_b, h + 1);
+    if (ok) {
+        bcd_bin_sub_in_place(middle, 2 * h + 2, r, 2 * h);
+        bcd_bin_sub_in_place(middle, 2 * h + 2, r + 2 * h, n1a + n1b);
+        bcd_bin_add_in_place(r + h, na + nb - h, middle, bcd_bin_significant(middle, 2 * h + 2));
+    }
+    bcd_arena_release(arena, mark);
+    return ok;
+}
+
+// Small binary -> BCD: peel eight digits at a time by dividing a scratch copy by 10^8
+static bool bcd_from_binary_basecase(BcdArena *arena, unsigned long *r, size_t nr, const uint32_t *limbs, size_t n)
+{
+    memset(r, 0, nr * sizeof(unsigned long));
+    size_t mark = bcd_arena_mark(arena);
+    uint32_t *tmp = BCD_ARENA_LIMBS(arena, n, false);
+    if (!tmp) return false;
+    memcpy(tmp, limbs, n * sizeof(uint32_t));
+    n = bcd_bin_significant(tmp, n);
+    for (size_t digit = 0; n > 0; digit += 8) {
+        uint64_t rem = 0;
+        for (size_t i = n; i-- > 0;) {
+            uint64_t cur = (rem << 32) | tmp[i];
+            tmp[i] = (uint32_t)(cur / 100000000U);
+            rem = cur % 100000000U;
+        }
+        r[digit / BCD_DIGITS_PER_WORD] |= (unsigned long)bcd_pack8((uint32_t)rem) << (4 * (digit % BCD_DIGITS_PER_WORD));
+        n = bcd_bin_significant(tmp, n);
+    }
+    bcd_arena_release(arena, mark);
+    return true;
+}
+
+/**
+ * @brief r[0..nr) = BCD of limbs[0..n), nr >= BCD_WORDS_FOR_LIMBS(n). Splits off the low
+ * h = 2^level limbs: x = hi * 2^(32h) + lo, with powers[level] = BCD of 2^(32h)
+ * (powers[i + 1] = powers[i]^2, built on first use).
+ */
+static bool bcd_from_binary_rec(BcdArena *arena, unsigned long *r, size_t nr, const uint32_t *limbs, size_t n,
+                                unsigned long **powers, size_t *power_words)
+{
+    n = bcd_bin_significant(limbs, n);
+    if (n <= BCD_CONV_BASE_LIMBS) return bcd_from_binary_basecase(arena, r, nr, limbs, n);
+
+    size_t level = 0;
+    while (((size_t)2 << level) < n) level++;
+    size_t h = (size_t)1 << level; // n / 2 < h < n
+
+    for (size_t i = 0; i <= level; i++) {
+        if (powers[i]) continue;
+        if (i == 0) {
+            power_words[0] = BCD_WORDS_FOR_LIMBS(1);
+            powers[0] = BCD_ARENA_WORDS(arena, power_words[0], true);
+            const uint32_t two_32[2] = { 0, 1 };
+            if (!powers[0] || !bcd_from_binary_basecase(arena, powers[0], power_words[0], two_32, 2)) return false;
+        } else {
+            size_t prev = bcd_significant_words(powers[i - 1], power_words[i - 1]);
+            power_words[i] = 2 * prev;
+            powers[i] = BCD_ARENA_WORDS(arena, power_words[i], false);
+            if (!powers[i] || !bcd_mul_words(arena, powers[i], powers[i - 1], prev, powers[i - 1], prev)) return false;
+        }
+    }
+
+    size_t nlo = BCD_WORDS_FOR_LIMBS(h), nhi = BCD_WORDS_FOR_LIMBS(n - h);
+    size_t np = bcd_significant_words(powers[level], power_words[level]);
+    size_t mark = bcd_arena_mark(arena); // After the powers, which outlive this call
+    unsigned long *buf = BCD_ARENA_WORDS(arena, nlo + nhi + nhi + np, false);
+    if (!buf) return false;
+    unsigned long *lo = buf, *hi = lo + nlo, *prod = hi + nhi;
+    bool ok = bcd_from_binary_rec(arena, lo, nlo, limbs, h, powers, power_words) &&
+              bcd_from_binary_rec(arena, hi, nhi, limbs + h, n - h, powers, power_words) &&
+              bcd_mul_words(arena, prod, hi, nhi, powers[level], np);
+    if (ok) {
+        size_t nprod = bcd_significant_words(prod, nhi + np);
+        size_t nl = bcd_significant_words(lo, nlo);
+        bcd_add_words(r, nr, prod, nprod, lo, nl);
+    }
+    bcd_arena_release(arena, mark);
+    return ok;
+}
+
+// Small BCD -> binary: Horner over eight-digit groups, r = r * 10^8 + group
+static void bcd_to_binary_basecase(uint32_t *r, size_t nr, const unsigned long *x, size_t nx)
+{
+    memset(r, 0, nr * sizeof(uint32_t));
+    size_t used = 0;
+    for (size_t w = nx; w-- > 0;) {
+        for (size_t c = BITSET_WORD_SIZE / 32; c-- > 0;) {
+            uint64_t carry = bcd_unpack8((uint32_t)(x[w] >> (32 * c)));
+            for (size_t i = 0; i < used; i++) {
+                carry += (uint64_t)r[i] * 100000000U;
+                r[i] = (uint32_t)carry;
+                carry >>= 32;
+            }
+            if (carry && used < nr) r[used++] = (uint32_t)carry;
+        }
+    }
+}
+
+/**
+ * @brief r[0..nr) = binary of x[0..nx), nr >= BCD_LIMBS_FOR_DIGITS(nx * BCD_DIGITS_PER_WORD).
+ * Splits off the low h = 2^level words: x = hi * 10^(h * BCD_DIGITS_PER_WORD) + lo, with
+ * powers[level] = that power of ten in binary (powers[i + 1] = powers[i]^2).
+ */
+static bool bcd_to_binary_rec(BcdArena *arena, uint32_t *r, size_t nr, const unsigned long *x, size_t nx,
+                              uint32_t **powers, size_t *power_limbs)
+{
+    nx = bcd_significant_words(x, nx);
+    if (nx <= BCD_CONV_BASE_WORDS) {
+        bcd_to_binary_basecase(r, nr, x, nx);
+        return true;
+    }
+
+    size_t level = 0;
+    while (((size_t)2 << level) < nx) level++;
+    size_t h = (size_t)1 << level;
+
+    for (size_t i = 0; i <= level; i++) {
+        if (powers[i]) continue;
+        if (i == 0) {
+            power_limbs[0] = BCD_LIMBS_FOR_DIGITS(BCD_DIGITS_PER_WORD + 1);
+            powers[0] = BCD_ARENA_LIMBS(arena, power_limbs[0], true);
+            if (!powers[0]) return false;
+            const unsigned long one_word[2] = { 0, 1 }; // 10^BCD_DIGITS_PER_WORD
+            bcd_to_binary_basecase(powers[0], power_limbs[0], one_word, 2);
+        } else {
+            size_t prev = bcd_bin_significant(powers[i - 1], power_limbs[i - 1]);
+            power_limbs[i] = 2 * prev;
+            powers[i] = BCD_ARENA_LIMBS(arena, power_limbs[i], false);
+            if (!powers[i] || !bcd_bin_mul(arena, powers[i], powers[i - 1], prev, powers[i - 1], prev)) return false;
+        }
+    }
+
+    size_t nlo = BCD_LIMBS_FOR_DIGITS(h * BCD_DIGITS_PER_WORD);
+    size_t nhi = BCD_LIMBS_FOR_DIGITS((nx - h) * BCD_DIGITS_PER_WORD);
+    size_t np = bcd_bin_significant(powers[level], power_limbs[level]);
+    size_t mark = bcd_arena_mark(arena); // After the powers, which outlive this call
+    uint32_t *buf = BCD_ARENA_LIMBS(arena, nlo + nhi + nhi + np, false);
+    if (!buf) return false;
+    uint32_t *lo = buf, *hi = lo + nlo, *prod = hi + nhi;
+    bool ok = bcd_to_binary_rec(arena, lo, nlo, x, h, powers, power_limbs) &&
+              bcd_to_binary_rec(arena, hi, nhi, x + h, nx - h, powers, power_limbs);
+    if (ok) {
+        size_t sig_hi = bcd_bin_significant(hi, nhi);
+        memset(r, 0, nr * sizeof(uint32_t));
+        if (sig_hi > 0) ok = bcd_bin_mul(arena, prod, hi, sig_hi, powers[level], np);
+        if (ok) {
+            size_t nprod = bcd_bin_significant(prod, sig_hi + np);
+            memcpy(r, prod, nprod * sizeof(uint32_t));
+            bcd_bin_add_in_place(r, nr, lo, bcd_bin_significant(lo, nlo));
+        }
+    }
+    bcd_arena_release(arena, mark);
+    return ok;
+}
+
+// Conversion levels never exceed the bit width of a size_t
+#define BCD_CONV_MAX_LEVELS (sizeof(size_t) * CHAR_BIT)
+
+/**
+ * @brief Builds a (positive) bitset from a binary magnitude given as little-endian 32-bit
+ * limbs. Divide and conquer over cached BCD powers of 2^32, so the cost follows BCD
+ * multiplication. Returns NULL on allocation failure.
+ */
+Bitset *bitset_from_binary(const uint32_t *limbs, size_t n_limbs)
+{
+    return bitset_from_binary_ex(limbs, n_limbs, NULL);
+}
+
+Bitset *bitset_from_binary_ex(const uint32_t *limbs, size_t n_limbs, BcdArena *arena)
+{
+    if (!limbs && n_limbs > 0) {
+        fprintf(stderr, "Error: NULL parameter passed to bitset_from_binary.\n");
+        return NULL;
+    }
+    size_t nr = BCD_WORDS_FOR_LIMBS(n_limbs);
+    size_t mark;
+    BcdArena *scratch = bcd_scratch_open(arena, 8 * nr * sizeof(unsigned long), &mark);
+    unsigned long *words = scratch ? BCD_ARENA_WORDS(scratch, nr, true) : NULL;
+    unsigned long *powers[BCD_CONV_MAX_LEVELS] = { NULL };
+    size_t power_words[BCD_CONV_MAX_LEVELS] = { 0 };
+    bool ok = words && bcd_from_binary_rec(scratch, words, nr, limbs, n_limbs, powers, power_words);
+
+    Bitset *result = NULL;
+    if (ok) {
+        size_t n = bcd_significant_words(words, nr);
+        size_t digits = n ? bcd_digit_length(words, n) : 1;
+        result = bitset_create(digits * 4);
+        if (result) memcpy(result->data, words, BCD_WORDS_FOR_BITS(digits * 4) * sizeof(unsigned long));
+    } else {
+        fprintf(stderr, "Error: allocation failed in bitset_from_binary\n");
+    }
+    if (scratch) bcd_scratch_close(scratch, arena, mark);
+    return result;
+}
+
+/**
+ * @brief Converts the magnitude of a bitset to binary: a malloc'd little-endian array of
+ * 32-bit limbs with no leading zero limbs (one zero limb for 0), count in *n_limbs.
+ * Divide and conquer over cached binary powers of 10. Returns NULL on failure.
+ */
+uint32_t *bitset_to_binary(const Bitset *bs, size_t *n_limbs)
+{
+    return bitset_to_binary_ex(bs, n_limbs, NULL);
+}
+
+uint32_t *bitset_to_binary_ex(const Bitset *bs, size_t *n_limbs, BcdArena *arena)
+{
+    if (!bs || !n_limbs) {
+        fprintf(stderr, "Error: NULL parameter passed to bitset_to_binary.\n");
+        return NULL;
+    }
+    size_t nx = bcd_significant_words(bs->data, BCD_WORDS_FOR_BITS(bs->size));
+    size_t nr = BCD_LIMBS_FOR_DIGITS(nx * BCD_DIGITS_PER_WORD);
+    uint32_t *limbs = (uint32_t *)calloc(nr, sizeof(uint32_t)); // Returned to the caller
+    uint32_t *powers[BCD_CONV_MAX_LEVELS] = { NULL };
+    size_t power_limbs[BCD_CONV_MAX_LEVELS] = { 0 };
+    size_t mark;
+    BcdArena *scratch = bcd_scratch_open(arena, 8 * nr * sizeof(uint32_t), &mark);
+    bool ok = limbs && scratch && bcd_to_binary_rec(scratch, limbs, nr, bs->data, nx, powers, power_limbs);
+    if (scratch) bcd_scratch_close(scratch, arena, mark);
+    if (!ok) {
+        fprintf(stderr, "Error: allocation failed in bitset_to_binary\n");
+        free(limbs);
+        return NULL;
+    }
+    size_t n = bcd_bin_significant(limbs, nr);
+    *n_limbs = n ? n : 1;
+    return limbs;
+}
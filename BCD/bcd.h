@@ -0,0 +1,146 @@
+/**
+ * @file bcd.h
+ * @brief Packed BCD arithmetic on arbitrary-length numbers (libbcd).
+ *
+ * Thread safety: the library keeps no mutable global state apart from atomic tuning knobs
+ * and per-thread allocation caches, so every function may be called from any number of
+ * threads at once. A Bitset or BcdArena that is being modified must not be used by another
+ * thread at the same time; Bitsets only read (const parameters) may be shared freely.
+ *
+ * Each thread caches freed buffers and a scratch arena. With POSIX threads they are returned
+ * to the heap when the thread exits; on other platforms a worker thread must call
+ * bcd_pool_trim() before it exits, or its caches leak.
+ */
+#ifndef BCD_H
+#define BCD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Define BITSET_WORD_SIZE
+#define BITSET_WORD_SIZE (sizeof(unsigned long) * 8)
+
+// Words stored inside the Bitset itself (32 digits), so small values need no data buffer
+#define BITSET_INLINE_WORDS (128 / BITSET_WORD_SIZE)
+
+// --- Struct Definition ---
+// data points at inline_words while the value fits, so a Bitset must not be copied by value;
+// use bitset_copy, or bitset_init / bitset_destroy for Bitsets embedded in other storage.
+typedef struct
+{
+    unsigned long *data; // Array to store bits
+    size_t size;         // Number of bits in the bitset
+    bool is_negative;    // Flag to indicate if the number is negative
+    size_t digits;       // Cached significant digit count (BITSET_DIGITS_UNKNOWN until computed)
+    size_t capacity;     // Allocated bits (whole words, >= size); bits from size up to here are zero
+    unsigned long inline_words[BITSET_INLINE_WORDS];
+} Bitset;
+
+typedef struct BcdArena BcdArena; // Scratch memory for the temporaries of one or many operations
+
+// Data buffers of 1, 2, 4, ... 2^(BCD_POOL_CLASSES-1) words are pooled per thread
+#define BCD_POOL_CLASSES 8
+
+// Allocation counters of the calling thread's pool (see bcd_pool_get_stats)
+typedef struct
+{
+    size_t header_hits, header_misses;          // Bitset structs reused / malloc'd
+    size_t data_hits[BCD_POOL_CLASSES];         // Buffers of 2^class words reused
+    size_t data_misses[BCD_POOL_CLASSES];       // Buffers of 2^class words calloc'd
+    size_t oversize;                            // Larger buffers, always from the heap
+} BcdPoolStats;
+
+// Bitset::digits before it is computed; anything that changes data must reset it to this
+#define BITSET_DIGITS_UNKNOWN ((size_t)-1)
+
+// --- Function Prototypes ---
+char *bitset_to_string_grouped_bcd(const Bitset *bitset);
+long long bcd_to_int(const Bitset *bs);
+size_t bitset_format_decimal(const Bitset *bs, char *buf, size_t buf_len); // snprintf style
+Bitset *bitset_from_binary(const uint32_t *limbs, size_t n_limbs); // Little-endian 32-bit limbs
+uint32_t *bitset_to_binary(const Bitset *bs, size_t *n_limbs);
+Bitset *bitset_from_binary_ex(const uint32_t *limbs, size_t n_limbs, BcdArena *arena);
+uint32_t *bitset_to_binary_ex(const Bitset *bs, size_t *n_limbs, BcdArena *arena);
+Bitset *bitset_create(size_t size);
+void bitset_free(Bitset *bitset);
+bool bitset_init(Bitset *bitset, size_t size); // In caller-provided storage
+void bitset_destroy(Bitset *bitset);           // Pairs with bitset_init
+void bitset_set(Bitset *bitset, size_t index, bool value);
+bool bitset_test(const Bitset *bitset, size_t index);
+Bitset *bitset_resize(const Bitset *bitset, size_t new_size, bool keep_sign);
+bool bitset_reserve(Bitset *bitset, size_t bits);                 // Grows capacity geometrically
+bool bitset_resize_in_place(Bitset *bitset, size_t new_size);     // Reallocates only past capacity
+void bitset_normalize(Bitset *bitset);                            // In-place trim, never reallocates
+bool bitset_add_in_place(Bitset *acc, const Bitset *b);           // acc = |acc| + |b|, grows on carry
+Bitset *bitset_copy(const Bitset *original);
+Bitset *bitset_add_with_carry(const Bitset *a, const Bitset *b); // Resizing Add
+void bitset_shift_left(Bitset *bitset, size_t shift);
+void bitset_shift_right(Bitset *bitset, size_t shift);
+bool bitset_shift_digits_left(Bitset *bitset, size_t digits);  // * 10^digits, grows size
+void bitset_shift_digits_right(Bitset *bitset, size_t digits); // / 10^digits, shrinks size
+char *bitset_to_string_normal(const Bitset *bitset);
+int bitset_compare(const Bitset *a, const Bitset *b);
+size_t bitset_digit_length(const Bitset *bs); // Cached in Bitset::digits
+Bitset *bitset_subtract_magnitude(const Bitset *a, const Bitset *b, bool *result_is_negative);
+Bitset *bitset_subtract_magnitude_complement(const Bitset *a, const Bitset *b, bool *result_is_negative);
+Bitset *int_to_bitset(int number);
+Bitset *bitset_from_string(const char *str); // Any length, optional sign
+Bitset *bcd_multiply_magnitude(const Bitset *a, const Bitset *b);
+Bitset *bcd_square(const Bitset *a);
+Bitset *bcd_divmod_magnitude(const Bitset *a, const Bitset *b, Bitset **remainder);
+Bitset *bcd_divmod(const Bitset *a, const Bitset *b, Bitset **remainder); // Truncated, C semantics
+// _ex variants take their temporaries from arena (NULL: the thread's shared scratch)
+Bitset *bcd_multiply_magnitude_ex(const Bitset *a, const Bitset *b, BcdArena *arena);
+Bitset *bcd_square_ex(const Bitset *a, BcdArena *arena);
+Bitset *bcd_divmod_magnitude_ex(const Bitset *a, const Bitset *b, Bitset **remainder, BcdArena *arena);
+Bitset *bcd_divmod_ex(const Bitset *a, const Bitset *b, Bitset **remainder, BcdArena *arena);
+Bitset *bcd_divide(const Bitset *a, const Bitset *b);
+Bitset *bcd_remainder(const Bitset *a, const Bitset *b);
+// Signed operations returning normalized results (no leading zeros, zero is never negative)
+Bitset *bcd_add(const Bitset *a, const Bitset *b);
+Bitset *bcd_sub(const Bitset *a, const Bitset *b);
+Bitset *bcd_mul(const Bitset *a, const Bitset *b);
+// In place: dst = a op b (dst may be a or b), acc op= b; false on bad input or allocation failure
+bool bcd_add_into(Bitset *dst, const Bitset *a, const Bitset *b);
+bool bcd_sub_into(Bitset *dst, const Bitset *a, const Bitset *b);
+bool bcd_mul_into(Bitset *dst, const Bitset *a, const Bitset *b);
+bool bcd_add_assign(Bitset *acc, const Bitset *b);
+bool bcd_sub_assign(Bitset *acc, const Bitset *b);
+bool bcd_mul_assign(Bitset *acc, const Bitset *b);
+bool bcd_mul_digit_assign(Bitset *acc, unsigned digit); // digit 0..9
+bool bcd_fma(Bitset *acc, const Bitset *a, const Bitset *b); // acc += a * b, signed
+Bitset *bcd_sum(const Bitset *const *values, size_t n); // Signed sum of many values at once
+Bitset *bcd_divmod_uint32(const Bitset *a, uint32_t divisor, uint32_t *remainder);
+uint32_t bcd_mod_uint32(const Bitset *a, uint32_t divisor);
+Bitset *bitset_trim_leading_zeros(const Bitset *original);
+bool bitset_is_zero(const Bitset *bs); // For shortcut
+void bcd_select_kernels(void);
+const char *bcd_selected_kernels(void);
+void bcd_set_karatsuba_threshold(size_t digits);
+size_t bcd_get_karatsuba_threshold(void);
+void bcd_set_toom3_threshold(size_t digits);
+size_t bcd_get_toom3_threshold(void);
+void bcd_set_ntt_threshold(size_t digits);
+size_t bcd_get_ntt_threshold(void);
+void bcd_set_newton_threshold(size_t digits);
+size_t bcd_get_newton_threshold(void);
+void bcd_tune_from_env(void);
+BcdArena *bcd_arena_create(size_t initial_bytes);
+void bcd_arena_destroy(BcdArena *arena);
+void bcd_arena_reset(BcdArena *arena);
+size_t bcd_arena_mark(const BcdArena *arena);
+void bcd_arena_release(BcdArena *arena, size_t mark); // Frees everything allocated after mark
+void bcd_pool_get_stats(BcdPoolStats *stats);
+void bcd_pool_reset_stats(void);
+void bcd_pool_trim(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BCD_H
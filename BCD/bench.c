@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "bcd.h"
+
+// --- Signed arithmetic benchmark ---
+// Times bcd_add / bcd_sub / bcd_mul against the sign dispatch that used to be inline in
+// main's switch (padded copies, sign-flipped copy, then a trimmed copy for printing),
+// a running total kept with bcd_add_assign against one built from fresh results, a sum of
+// products with bcd_fma against a product per term, and one bcd_sum over a column against
+// an add chain.
+// Usage: bcd_bench [max_digits]
+
+#define BENCH_PAIRS 64      // Operand pairs per size
+#define BENCH_COLUMN 20000  // Values per column sum, cycling through the operands
+
+typedef Bitset *(*BenchOp)(const Bitset *a, const Bitset *b);
+
+// Old case 3 / 4 body: pad both operands to a common size, add or subtract magnitudes
+static Bitset *inline_add_sub(const Bitset *num1, const Bitset *num2, bool subtract)
+{
+    Bitset *result = NULL;
+    bool result_negative = false;
+    if (bitset_is_zero(num2)) { result = bitset_copy(num1); if (result) result_negative = result->is_negative; }
+    else if (bitset_is_zero(num1)) { result = bitset_copy(num2); if (result) result_negative = subtract ? !result->is_negative : result->is_negative; }
+    else {
+        size_t max_size = (num1->size > num2->size) ? num1->size : num2->size;
+        if (max_size % 4 != 0) max_size = ((max_size + 3) / 4) * 4;
+        if (max_size == 0) max_size = 4;
+        Bitset *n1_op = bitset_resize(num1, max_size, true);
+        Bitset *n2_op = bitset_resize(num2, max_size, true);
+        if (n1_op && n2_op) {
+            if (subtract) n2_op->is_negative = !n2_op->is_negative;
+            if (n1_op->is_negative == n2_op->is_negative) {
+                result = bitset_add_with_carry(n1_op, n2_op);
+                result_negative = n1_op->is_negative;
+            } else if (n1_op->is_negative) {
+                result = bitset_subtract_magnitude(n2_op, n1_op, &result_negative);
+            } else {
+                result = bitset_subtract_magnitude(n1_op, n2_op, &result_negative);
+            }
+        }
+        bitset_free(n1_op);
+        bitset_free(n2_op);
+    }
+    if (!result) return NULL;
+    result->is_negative = result_negative;
+    Bitset *trimmed = bitset_trim_leading_zeros(result);
+    bitset_free(result);
+    return trimmed;
+}
+
+static Bitset *inline_add(const Bitset *a, const Bitset *b) { return inline_add_sub(a, b, false); }
+static Bitset *inline_sub(const Bitset *a, const Bitset *b) { return inline_add_sub(a, b, true); }
+
+// Old case 5 body
+static Bitset *inline_mul(const Bitset *num1, const Bitset *num2)
+{
+    Bitset *product;
+    bool negative = false;
+    if (bitset_is_zero(num1) || bitset_is_zero(num2)) product = bitset_create(4);
+    else {
+        product = bcd_multiply_magnitude(num1, num2);
+        negative = (num1->is_negative != num2->is_negative);
+    }
+    if (!product) return NULL;
+    product->is_negative = negative;
+    Bitset *trimmed = bitset_trim_leading_zeros(product);
+    bitset_free(product);
+    return trimmed;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Random signed operand of exactly digits digits (first digit nonzero)
+static Bitset *random_operand(size_t digits)
+{
+    char *text = (char *)malloc(digits + 2);
+    if (!text) return NULL;
+    size_t pos = 0;
+    if (rand() & 1) text[pos++] = '-';
+    text[pos++] = (char)('1' + rand() % 9);
+    for (size_t i = 1; i < digits; i++) text[pos++] = (char)('0' + rand() % 10);
+    text[pos] = '\0';
+    Bitset *value = bitset_from_string(text);
+    free(text);
+    return value;
+}
+
+// Both results must exist and agree in sign and magnitude
+static bool same_result(BenchOp op, BenchOp check, const Bitset *a, const Bitset *b)
+{
+    Bitset *x = op(a, b);
+    Bitset *y = check(a, b);
+    bool same = x && y && x->is_negative == y->is_negative && bitset_compare(x, y) == 0;
+    bitset_free(x);
+    bitset_free(y);
+    return same;
+}
+
+// Nanoseconds per call of op over all operand pairs
+static double time_op(BenchOp op, Bitset **a, Bitset **b, size_t pairs, size_t rounds)
+{
+    double start = now_seconds();
+    for (size_t r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < pairs; i++) bitset_free(op(a[i], b[i]));
+    }
+    return (now_seconds() - start) * 1e9 / (double)(rounds * pairs);
+}
+
+// --- Total rows: one total built two ways, timed and compared ---
+typedef struct
+{
+    Bitset **a, **b;
+    size_t pairs;
+    size_t rounds; // Passes over the operands
+    const Bitset *const *column;
+    size_t column_len;
+} BenchInput;
+
+typedef Bitset *(*BenchTotal)(const BenchInput *in); // NULL on failure
+
+// total = total + a[i], a fresh Bitset per step
+static Bitset *total_fresh(const BenchInput *in)
+{
+    Bitset *total = bitset_create(4);
+    for (size_t r = 0; r < in->rounds && total; r++) {
+        for (size_t i = 0; i < in->pairs && total; i++) {
+            Bitset *next = bcd_add(total, in->a[i]);
+            bitset_free(total);
+            total = next;
+        }
+    }
+    return total;
+}
+
+static Bitset *total_assign(const BenchInput *in)
+{
+    Bitset *total = bitset_create(4);
+    for (size_t r = 0; r < in->rounds && total; r++) {
+        for (size_t i = 0; i < in->pairs; i++) bcd_add_assign(total, in->a[i]);
+    }
+    return total;
+}
+
+// Sum of a[i] * b[i]: a product Bitset per term added into the total
+static Bitset *dot_separate(const BenchInput *in)
+{
+    Bitset *total = bitset_create(4);
+    for (size_t r = 0; r < in->rounds && total; r++) {
+        for (size_t i = 0; i < in->pairs; i++) {
+            Bitset *product = bcd_mul(in->a[i], in->b[i]);
+            bcd_add_assign(total, product);
+            bitset_free(product);
+        }
+    }
+    return total;
+}
+
+static Bitset *dot_fused(const BenchInput *in)
+{
+    Bitset *total = bitset_create(4);
+    for (size_t r = 0; r < in->rounds && total; r++) {
+        for (size_t i = 0; i < in->pairs; i++) bcd_fma(total, in->a[i], in->b[i]);
+    }
+    return total;
+}
+
+// Column summed by a bcd_add_assign chain versus one bcd_sum call
+static Bitset *column_chain(const BenchInput *in)
+{
+    Bitset *total = bitset_create(4);
+    for (size_t i = 0; i < in->column_len && total; i++) bcd_add_assign(total, in->column[i]);
+    return total;
+}
+
+static Bitset *column_sum(const BenchInput *in)
+{
+    return bcd_sum(in->column, in->column_len);
+}
+
+// Nanoseconds per step of one total; *total receives the result
+static double time_total(BenchTotal build, const BenchInput *in, size_t steps, Bitset **total)
+{
+    double start = now_seconds();
+    *total = build(in);
+    return (now_seconds() - start) * 1e9 / (double)steps;
+}
+
+/**
+ * @brief Prints one row: baseline against library, best of five, steps per total.
+ * Returns false (and reports) when a total fails or the two disagree.
+ */
+static bool bench_row(const char *name, const char *label, BenchTotal baseline, BenchTotal library,
+                      const BenchInput *in, size_t steps, size_t digits)
+{
+    double old_ns = 0, new_ns = 0;
+    for (int rep = 0; rep < 5; rep++) {
+        Bitset *old_total, *new_total;
+        double t_old = time_total(baseline, in, steps, &old_total);
+        double t_new = time_total(library, in, steps, &new_total);
+        bool same = old_total && new_total && old_total->is_negative == new_total->is_negative &&
+                    bitset_compare(old_total, new_total) == 0;
+        bitset_free(old_total);
+        bitset_free(new_total);
+        if (!same) {
+            fprintf(stderr, "Error: %s totals differ at %zu digits.\n", name, digits);
+            return false;
+        }
+        if (rep == 0 || t_old < old_ns) old_ns = t_old;
+        if (rep == 0 || t_new < new_ns) new_ns = t_new;
+    }
+    printf("%-4s %8zu %14.1f %14.1f %7.2fx  (%s)\n", name, digits, old_ns, new_ns, old_ns / new_ns, label);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    size_t max_digits = (argc > 1) ? (size_t)strtoull(argv[1], NULL, 10) : 10000;
+    const size_t pairs = BENCH_PAIRS;
+    const struct { const char *name; BenchOp library, old; } ops[] = {
+        { "add", bcd_add, inline_add },
+        { "sub", bcd_sub, inline_sub },
+        { "mul", bcd_mul, inline_mul },
+    };
+
+    srand(12345);
+    printf("kernels: %s\n", bcd_selected_kernels());
+    printf("%-4s %8s %14s %14s %8s\n", "op", "digits", "inline ns/op", "library ns/op", "speedup");
+    for (size_t digits = 8; digits <= max_digits; digits *= 4) {
+        Bitset *a[BENCH_PAIRS], *b[BENCH_PAIRS];
+        for (size_t i = 0; i < pairs; i++) {
+            a[i] = random_operand(digits);
+            b[i] = random_operand(digits - rand() % (digits / 2 + 1)); // Unequal lengths too
+        }
+        for (size_t k = 0; k < sizeof(ops) / sizeof(ops[0]); k++) {
+            // Aim for a comparable amount of work at every size
+            size_t cost = (k == 2) ? digits * digits / 64 + 1 : digits;
+            size_t rounds = 1000000 / (pairs * cost) + 1;
+            for (size_t i = 0; i < pairs; i++) {
+                if (!same_result(ops[k].library, ops[k].old, a[i], b[i])) {
+                    fprintf(stderr, "Error: %s results differ at %zu digits.\n", ops[k].name, digits);
+                    return 1;
+                }
+            }
+            double old_ns = 0, new_ns = 0;
+            for (int rep = 0; rep < 5; rep++) { // Best of five, alternating, to damp noise
+                double t_old = time_op(ops[k].old, a, b, pairs, rounds);
+                double t_new = time_op(ops[k].library, a, b, pairs, rounds);
+                if (rep == 0 || t_old < old_ns) old_ns = t_old;
+                if (rep == 0 || t_new < new_ns) new_ns = t_new;
+            }
+            printf("%-4s %8zu %14.1f %14.1f %7.2fx\n", ops[k].name, digits, old_ns, new_ns, old_ns / new_ns);
+        }
+        BenchInput in = { a, b, pairs, 200000 / (pairs * digits) + 1, NULL, 0 };
+        if (!bench_row("+=", "bcd_add vs bcd_add_assign", total_fresh, total_assign, &in, in.rounds * pairs, digits)) {
+            return 1;
+        }
+        in.rounds = 200000 / (pairs * (digits * digits / 64 + 1)) + 1;
+        if (!bench_row("fma", "bcd_mul + add vs bcd_fma", dot_separate, dot_fused, &in, in.rounds * pairs, digits)) {
+            return 1;
+        }
+        const Bitset *column[BENCH_COLUMN];
+        for (size_t i = 0; i < BENCH_COLUMN; i++) column[i] = (i & 1) ? b[(i / 2) % pairs] : a[(i / 2) % pairs];
+        in.column = column;
+        in.column_len = BENCH_COLUMN;
+        if (!bench_row("sum", "bcd_add_assign chain vs bcd_sum", column_chain, column_sum, &in, BENCH_COLUMN, digits)) {
+            return 1;
+        }
+        for (size_t i = 0; i < pairs; i++) { bitset_free(a[i]); bitset_free(b[i]); }
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "bcd.h"
+
+// --- Main Function (With Zero Shortcuts) ---
+
+// Reads one line of any length from stdin (without the newline); NULL on EOF or allocation failure
+static char *read_input_line(void)
+{
+    size_t cap = 64, len = 0;
+    char *line = (char *)malloc(cap);
+    if (!line) return NULL;
+    int c;
+    while ((c = getchar()) != EOF && c != '\n') {
+        if (len + 1 == cap) {
+            char *grown = (char *)realloc(line, cap * 2);
+            if (!grown) { free(line); return NULL; }
+            line = grown;
+            cap *= 2;
+        }
+        line[len++] = (char)c;
+    }
+    if (c == EOF && len == 0) { free(line); return NULL; }
+    line[len] = '\0';
+    return line;
+}
+
+// Normalizes a menu result in place (also clears the sign of zero) and prints it in BCD and decimal (any length)
+static void print_bcd_result(const char *op_name, Bitset *value)
+{
+    bitset_normalize(value);
+
+    char* s_bcd = bitset_to_string_grouped_bcd(value); // Use grouped BCD string
+    size_t decimal_len = bitset_format_decimal(value, NULL, 0); // Any length, '-' for negative
+    char *s_decimal = (char *)malloc(decimal_len + 1);
+    if (s_decimal) bitset_format_decimal(value, s_decimal, decimal_len + 1);
+
+    printf("%s:\n", op_name); // Print operation name
+    printf("  BCD:     %s%s\n",
+           value->is_negative ? "1111 " : "", // Use 1111 for negative BCD
+           s_bcd ? s_bcd : "Error");
+    printf("  Decimal: %s\n", s_decimal ? s_decimal : "Error converting BCD");
+    free(s_bcd);
+    free(s_decimal);
+}
+
+int main()
+{
+    Bitset *num1 = NULL;
+    Bitset *num2 = NULL;
+    int choice;
+
+    bcd_tune_from_env(); // Per-host multiplication and division cutoffs
+
+    while (1)
+    {
+        printf("\nCurrent Numbers:\n");
+        char *s1 = num1 ? bitset_to_string_normal(num1) : NULL;
+        printf("Number 1: %s%s\n",
+               (num1 && num1->is_negative) ? "1111 " : "",
+               s1 ? s1 : "Not set");
+        free(s1);
+
+        char *s2 = num2 ? bitset_to_string_normal(num2) : NULL;
+        printf("Number 2: %s%s\n",
+               (num2 && num2->is_negative) ? "1111 " : "",
+               s2 ? s2 : "Not set");
+        free(s2);
+
+        printf("\nMenu:\n");
+        printf("1. Enter Number 1\n");
+        printf("2. Enter Number 2\n");
+        printf("3. Add (Number 1 + Number 2)\n");
+        printf("4. Subtract (Number 1 - Number 2)\n");
+        printf("5. Multiply (Number 1 * Number 2)\n");
+        printf("6. Compare (Number 1 vs Number 2)\n"); // Compare including sign
+        printf("7. Divide (Number 1 / Number 2, with remainder)\n");
+        printf("8. Exit\n");
+        printf("Enter choice: ");
+
+        if (scanf("%d", &choice) != 1) {
+            printf("Invalid input. Please enter a number.\n");
+            while (getchar() != '\n'); // Clear input buffer
+            continue;
+        }
+        while (getchar() != '\n'); // Clear potential newline
+
+
+        switch (choice)
+        {
+            case 1: // Enter Number 1
+                printf("Enter a decimal number for Number 1: ");
+                {
+                    char *line = read_input_line(); // Any number of digits
+                    Bitset *parsed = line ? bitset_from_string(line) : NULL;
+                    free(line);
+                    if (!parsed) { printf("Error creating bitset for Number 1.\n"); break; }
+                    if (num1) bitset_free(num1);
+                    num1 = parsed;
+                }
+                break;
+
+            case 2: // Enter Number 2
+                printf("Enter a decimal number for Number 2: ");
+                {
+                    char *line = read_input_line(); // Any number of digits
+                    Bitset *parsed = line ? bitset_from_string(line) : NULL;
+                    free(line);
+                    if (!parsed) { printf("Error creating bitset for Number 2.\n"); break; }
+                    if (num2) bitset_free(num2);
+                    num2 = parsed;
+                }
+                break;
+
+            case 3: // Add (the library handles signs, zero and trimming)
+                if (num1 && num2)
+                {
+                    Bitset *result = bcd_add(num1, num2);
+                    if (result) {
+                        print_bcd_result("Sum", result);
+                        bitset_free(result);
+                    } else { printf("Error during calculation.\n"); }
+                } else { printf("Error: Both numbers must be set first.\n"); }
+                break; // End Case 3
+
+
+            case 4: // Subtract
+                if (num1 && num2)
+                {
+                    Bitset *result = bcd_sub(num1, num2);
+                    if (result) {
+                        print_bcd_result("Difference", result);
+                        bitset_free(result);
+                    } else { printf("Error during calculation.\n"); }
+                } else { printf("Error: Both numbers must be set first.\n"); }
+                break; // End Case 4
+
+
+            case 5: // Multiply
+                if (num1 && num2)
+                {
+                    Bitset *result = bcd_mul(num1, num2);
+                    if (result) {
+                        print_bcd_result("Product", result);
+                        bitset_free(result);
+                    } else { printf("Error during calculation.\n"); }
+                } else { printf("Error: Both numbers must be set first.\n"); }
+                break; // End Case 5
+
+            case 6: // Compare (Handles Signs)
+                if (num1 && num2)
+                {
+                    int final_cmp;
+                    if (!num1->is_negative && num2->is_negative) final_cmp = 1;
+                    else if (num1->is_negative && !num2->is_negative) final_cmp = -1;
+                    else {
+                        int mag_cmp = bitset_compare(num1, num2);
+                        final_cmp = num1->is_negative ? -mag_cmp : mag_cmp;
+                    }
+
+                    printf("Comparison Result (Number 1 vs Number 2):\n");
+                    if (final_cmp < 0) printf("Number 1 < Number 2\n");
+                    else if (final_cmp > 0) printf("Number 1 > Number 2\n");
+                    else printf("Number 1 == Number 2\n");
+                } else { /* Error message */ }
+                break;
+
+            case 7: // Divide (Truncated quotient and remainder, signs as in C)
+                if (num1 && num2)
+                {
+                    if (bitset_is_zero(num2)) { printf("Error: Division by zero.\n"); break; }
+                    Bitset *rem = NULL;
+                    Bitset *quot = bcd_divmod(num1, num2, &rem);
+                    if (quot && rem) {
+                        print_bcd_result("Quotient", quot);
+                        print_bcd_result("Remainder", rem);
+                    } else { printf("Error during calculation.\n"); }
+                    bitset_free(quot);
+                    bitset_free(rem);
+                } else { printf("Error: Both numbers must be set first.\n"); }
+                break; // End Case 7
+
+            case 8: // Exit
+                printf("Exiting.\n");
+                if (num1) bitset_free(num1);
+                if (num2) bitset_free(num2);
+                return 0;
+
+            default:
+                printf("Invalid choice. Please try again.\n");
+        }
+    } // End while loop
+
+    // Should not be reached
+    if (num1) bitset_free(num1);
+    if (num2) bitset_free(num2);
+    return 0;
+} // End main
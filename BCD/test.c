@@ -0,0 +1,434 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bcd.h"
+
+// --- libbcd tests ---
+// Runs every multiplication and division tier on known results, with the cutoffs lowered
+// so that moderate operands reach each tier, then the parser, formatter, binary conversion
+// and the signed, in-place, fma and sum entry points on signs, zero and aliased operands.
+// Prints each failure and exits nonzero if there was any.
+
+static int failures;
+
+// Digit strings built by the tests; freed at exit
+#define TEST_MAX_STRINGS 64
+static char *strings[TEST_MAX_STRINGS];
+static size_t string_count;
+
+static char *keep(char *s)
+{
+    if (!s || string_count == TEST_MAX_STRINGS) {
+        fprintf(stderr, "Error: out of test strings.\n");
+        exit(2);
+    }
+    strings[string_count++] = s;
+    return s;
+}
+
+static char *to_string(const Bitset *bs)
+{
+    size_t len = bitset_format_decimal(bs, NULL, 0);
+    char *s = (char *)malloc(len + 1);
+    if (s) bitset_format_decimal(bs, s, len + 1);
+    return s;
+}
+
+/**
+ * @brief Checks that bs prints as expected. A normalized result must also have no leading
+ * zero digits and the expected sign (zero is never negative).
+ */
+static void expect(const Bitset *bs, const char *expected, bool normalized, const char *what)
+{
+    char *s = bs ? to_string(bs) : NULL;
+    bool ok = s && strcmp(s, expected) == 0;
+    if (ok && normalized) {
+        bool negative = expected[0] == '-';
+        ok = bs->size == 4 * (strlen(expected) - negative) && bs->is_negative == negative;
+    }
+    if (!ok) {
+        failures++;
+        fprintf(stderr, "FAIL %s: got %.48s%s (size %zu), expected %.48s%s\n", what, s ? s : "NULL",
+                (s && strlen(s) > 48) ? "..." : "", bs ? bs->size : 0, expected, strlen(expected) > 48 ? "..." : "");
+    }
+    free(s);
+}
+
+// expect(), then frees bs
+static void expect_free(Bitset *bs, const char *expected, bool normalized, const char *what)
+{
+    expect(bs, expected, normalized, what);
+    bitset_free(bs);
+}
+
+static void expect_true(bool ok, const char *what)
+{
+    if (!ok) {
+        failures++;
+        fprintf(stderr, "FAIL %s\n", what);
+    }
+}
+
+// n copies of digit
+static char *repeat(char digit, size_t n)
+{
+    char *s = keep((char *)malloc(n + 1));
+    memset(s, digit, n);
+    s[n] = '\0';
+    return s;
+}
+
+// (10^n - 1)^2 = (n-1 nines) 8 (n-1 zeros) 1
+static char *square_of_nines(size_t n)
+{
+    char *s = keep((char *)malloc(2 * n + 1));
+    memset(s, '9', n - 1);
+    s[n - 1] = '8';
+    memset(s + n, '0', n - 1);
+    s[2 * n - 1] = '1';
+    s[2 * n] = '\0';
+    return s;
+}
+
+// n pseudo-random digits with a nonzero leading digit
+static char *random_digits(size_t n, uint32_t seed)
+{
+    char *s = keep((char *)malloc(n + 1));
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        s[i] = (char)('0' + (seed >> 24) % 10);
+    }
+    if (s[0] == '0') s[0] = '7';
+    s[n] = '\0';
+    return s;
+}
+
+// --- Multiplication and division tiers ---
+typedef struct
+{
+    const char *name;
+    size_t karatsuba, toom3, ntt, newton; // Cutoffs in digits; 0 clamps to the smallest allowed
+} Tier;
+
+#define TIER_OFF SIZE_MAX
+
+static const Tier tiers[] = {
+    {"schoolbook", TIER_OFF, TIER_OFF, TIER_OFF, TIER_OFF},
+    {"karatsuba", 0, TIER_OFF, TIER_OFF, TIER_OFF},
+    {"toom3", 0, 0, TIER_OFF, TIER_OFF},
+    {"ntt", 0, 0, 0, TIER_OFF},
+    {"newton", 0, 0, 0, 0},
+};
+
+// Operands shared by every tier, with products taken from the schoolbook tier
+typedef struct
+{
+    const char *a, *b, *c;    // c has fewer digits than b
+    const char *short_b;      // For unbalanced products
+    const char *ab, *a_short; // a * b, a * short_b
+    const char *abc;          // a * b + c
+} TierOperands;
+
+static void test_tier(const Tier *tier, const TierOperands *op)
+{
+    char what[96];
+    bcd_set_karatsuba_threshold(tier->karatsuba);
+    bcd_set_toom3_threshold(tier->toom3);
+    bcd_set_ntt_threshold(tier->ntt);
+    bcd_set_newton_threshold(tier->newton);
+
+    Bitset *x = bitset_from_string("12345678901234567890");
+    Bitset *y = bitset_from_string("98765432109876543210");
+    snprintf(what, sizeof(what), "%s: 20-digit product", tier->name);
+    expect_free(bcd_multiply_magnitude(x, y), "1219326311370217952237463801111263526900", false, what);
+    bitset_free(x);
+    bitset_free(y);
+
+    static const size_t nines[] = {1, 17, 40, 300, 2000};
+    for (size_t i = 0; i < sizeof(nines) / sizeof(nines[0]); i++) {
+        Bitset *n1 = bitset_from_string(repeat('9', nines[i]));
+        Bitset *n2 = bitset_copy(n1);
+        const char *expected = square_of_nines(nines[i]);
+        snprintf(what, sizeof(what), "%s: (10^%zu - 1)^2", tier->name, nines[i]);
+        expect_free(bcd_multiply_magnitude(n1, n2), expected, false, what);
+        snprintf(what, sizeof(what), "%s: bcd_square(10^%zu - 1)", tier->name, nines[i]);
+        expect_free(bcd_square(n1), expected, false, what);
+        bitset_free(n1);
+        bitset_free(n2);
+    }
+
+    Bitset *a = bitset_from_string(op->a), *b = bitset_from_string(op->b), *c = bitset_from_string(op->c);
+    Bitset *short_b = bitset_from_string(op->short_b);
+    snprintf(what, sizeof(what), "%s: a * b", tier->name);
+    expect_free(bcd_multiply_magnitude(a, b), op->ab, false, what);
+    snprintf(what, sizeof(what), "%s: a * short_b", tier->name);
+    expect_free(bcd_multiply_magnitude(a, short_b), op->a_short, false, what);
+
+    // a * b + c through bcd_fma, then divided back into a remainder c
+    Bitset *abc = bitset_copy(c);
+    snprintf(what, sizeof(what), "%s: bcd_fma(c, a, b)", tier->name);
+    expect_true(bcd_fma(abc, a, b), what);
+    expect(abc, op->abc, true, what);
+    Bitset *rem = NULL;
+    snprintf(what, sizeof(what), "%s: (a * b + c) / b", tier->name);
+    expect_free(bcd_divmod_magnitude(abc, b, &rem), op->a, false, what);
+    snprintf(what, sizeof(what), "%s: (a * b + c) %% b", tier->name);
+    expect_free(rem, op->c, false, what);
+
+    Bitset *ten40 = bitset_from_string("10000000000000000000000000000000000000000");
+    Bitset *seven = int_to_bitset(7);
+    snprintf(what, sizeof(what), "%s: 10^40 / 7", tier->name);
+    expect_free(bcd_divmod_magnitude(ten40, seven, &rem), "1428571428571428571428571428571428571428", false, what);
+    snprintf(what, sizeof(what), "%s: 10^40 %% 7", tier->name);
+    expect_free(rem, "4", false, what);
+
+    bitset_free(ten40);
+    bitset_free(seven);
+    bitset_free(abc);
+    bitset_free(a);
+    bitset_free(b);
+    bitset_free(c);
+    bitset_free(short_b);
+}
+
+static void test_tiers(void)
+{
+    size_t karatsuba = bcd_get_karatsuba_threshold(), toom3 = bcd_get_toom3_threshold();
+    size_t ntt = bcd_get_ntt_threshold(), newton = bcd_get_newton_threshold();
+
+    TierOperands op;
+    op.a = random_digits(1500, 1);
+    op.b = random_digits(1100, 2);
+    op.c = random_digits(900, 3);
+    op.short_b = random_digits(300, 4);
+
+    // Reference products on the schoolbook tier, checked there against a * b = b * a
+    bcd_set_karatsuba_threshold(TIER_OFF);
+    bcd_set_toom3_threshold(TIER_OFF);
+    bcd_set_ntt_threshold(TIER_OFF);
+    Bitset *a = bitset_from_string(op.a), *b = bitset_from_string(op.b), *c = bitset_from_string(op.c);
+    Bitset *short_b = bitset_from_string(op.short_b);
+    Bitset *ab = bcd_multiply_magnitude(a, b), *ba = bcd_multiply_magnitude(b, a);
+    Bitset *a_short = bcd_multiply_magnitude(a, short_b);
+    Bitset *abc = bcd_add(ab, c);
+    expect_true(ab && ba && bitset_compare(ab, ba) == 0, "schoolbook: a * b == b * a");
+    op.ab = keep(to_string(ab));
+    op.a_short = keep(to_string(a_short));
+    op.abc = keep(to_string(abc));
+    Bitset *tmp[] = {a, b, c, short_b, ab, ba, a_short, abc};
+    for (size_t i = 0; i < sizeof(tmp) / sizeof(tmp[0]); i++) bitset_free(tmp[i]);
+
+    for (size_t i = 0; i < sizeof(tiers) / sizeof(tiers[0]); i++) test_tier(&tiers[i], &op);
+
+    bcd_set_karatsuba_threshold(karatsuba);
+    bcd_set_toom3_threshold(toom3);
+    bcd_set_ntt_threshold(ntt);
+    bcd_set_newton_threshold(newton);
+}
+
+// --- Signed division, machine-integer division ---
+static void test_division(void)
+{
+    static const struct { int a, b; const char *q, *r; } signs[] = {
+        {-7, 2, "-3", "-1"}, {7, -2, "-3", "1"}, {-7, -2, "3", "-1"}, {6, -3, "-2", "0"}, {0, -5, "0", "0"},
+    };
+    char what[64];
+    for (size_t i = 0; i < sizeof(signs) / sizeof(signs[0]); i++) {
+        Bitset *a = int_to_bitset(signs[i].a), *b = int_to_bitset(signs[i].b), *rem = NULL;
+        snprintf(what, sizeof(what), "bcd_divmod(%d, %d)", signs[i].a, signs[i].b);
+        expect_free(bcd_divmod(a, b, &rem), signs[i].q, false, what);
+        snprintf(what, sizeof(what), "bcd_divmod(%d, %d) remainder", signs[i].a, signs[i].b);
+        expect_free(rem, signs[i].r, false, what);
+        bitset_free(a);
+        bitset_free(b);
+    }
+
+    Bitset *ten40 = bitset_from_string("-10000000000000000000000000000000000000000");
+    uint32_t rem = 0;
+    expect_free(bcd_divmod_uint32(ten40, 4294967295u, &rem), "-2328306437080797375431469961868", false,
+                "bcd_divmod_uint32(-10^40, 2^32 - 1)");
+    expect_true(rem == 2042892940u, "bcd_divmod_uint32 remainder");
+    expect_true(bcd_mod_uint32(ten40, 7) == 4, "bcd_mod_uint32(-10^40, 7)");
+    bitset_free(ten40);
+
+    Bitset *nines = bitset_from_string(repeat('9', 100));
+    expect_free(bcd_divmod_uint32(nines, 9, &rem), repeat('1', 100), false, "bcd_divmod_uint32(10^100 - 1, 9)");
+    expect_true(rem == 0, "bcd_divmod_uint32(10^100 - 1, 9) remainder");
+    bitset_free(nines);
+}
+
+// --- Parsing, formatting, binary conversion ---
+static void test_conversion(void)
+{
+    static const struct { const char *in, *out; } parse[] = {
+        {"-000123", "-123"}, {"+42", "42"}, {"  7 \n", "7"}, {"-0", "0"}, {"0000", "0"},
+        {"123456789012345678901234567890123", "123456789012345678901234567890123"},
+    };
+    for (size_t i = 0; i < sizeof(parse) / sizeof(parse[0]); i++) {
+        expect_free(bitset_from_string(parse[i].in), parse[i].out, false, parse[i].in);
+    }
+
+    uint32_t all_ones[] = {0xFFFFFFFFu, 0xFFFFFFFFu};
+    expect_free(bitset_from_binary(all_ones, 2), "18446744073709551615", false, "bitset_from_binary(2^64 - 1)");
+    Bitset *two64 = bitset_from_string("18446744073709551616");
+    size_t n_limbs = 0;
+    uint32_t *limbs = bitset_to_binary(two64, &n_limbs);
+    expect_true(limbs && n_limbs == 3 && limbs[0] == 0 && limbs[1] == 0 && limbs[2] == 1, "bitset_to_binary(2^64)");
+    free(limbs);
+    bitset_free(two64);
+
+    const char *big = random_digits(3000, 5);
+    Bitset *value = bitset_from_string(big);
+    limbs = bitset_to_binary(value, &n_limbs);
+    expect_free(limbs ? bitset_from_binary(limbs, n_limbs) : NULL, big, false, "3000-digit binary round trip");
+    free(limbs);
+    bitset_free(value);
+}
+
+// --- Signed add / sub / mul, in-place forms, fma, sum ---
+typedef struct
+{
+    const char *a, *b;
+    const char *sum, *diff, *prod;
+    const char *a_fma, *b_fma; // a + a * b, b + a * b
+} SignedCase;
+
+static const SignedCase signed_cases[] = {
+    {"5", "-5", "0", "10", "-25", "-20", "-30"},
+    {"-123", "45", "-78", "-168", "-5535", "-5658", "-5490"},
+    {"0", "-7", "-7", "7", "0", "0", "-7"},
+    {"999999999999999999", "1", "1000000000000000000", "999999999999999998", "999999999999999999",
+     "1999999999999999998", "1000000000000000000"},
+    {"-1", "-99999999999999999999999999999999999", "-100000000000000000000000000000000000",
+     "99999999999999999999999999999999998", "99999999999999999999999999999999999",
+     "99999999999999999999999999999999998", "0"},
+    {"100000000000000000000000000000000", "-1", "99999999999999999999999999999999",
+     "100000000000000000000000000000001", "-100000000000000000000000000000000", "0",
+     "-100000000000000000000000000000001"},
+    {"-98765432109876543210987654321", "-98765432109876543210987654321", "-197530864219753086421975308642", "0",
+     "9754610579850632525872580399356500533456774881877789971041",
+     "9754610579850632525872580399257735101346898338666802316720",
+     "9754610579850632525872580399257735101346898338666802316720"},
+};
+
+typedef bool (*IntoOp)(Bitset *dst, const Bitset *a, const Bitset *b);
+typedef bool (*AssignOp)(Bitset *acc, const Bitset *b);
+
+static void test_signed_case(const SignedCase *t)
+{
+    static const char *names[] = {"add", "sub", "mul"};
+    static const IntoOp into[] = {bcd_add_into, bcd_sub_into, bcd_mul_into};
+    static const AssignOp assign[] = {bcd_add_assign, bcd_sub_assign, bcd_mul_assign};
+    Bitset *(*const fresh[])(const Bitset *, const Bitset *) = {bcd_add, bcd_sub, bcd_mul};
+    const char *expected[] = {t->sum, t->diff, t->prod};
+    Bitset *a = bitset_from_string(t->a), *b = bitset_from_string(t->b);
+    char what[160];
+
+    for (int op = 0; op < 3; op++) {
+        snprintf(what, sizeof(what), "bcd_%s(%s, %s)", names[op], t->a, t->b);
+        expect_free(fresh[op](a, b), expected[op], true, what);
+
+        Bitset *dst = bitset_create(4);
+        snprintf(what, sizeof(what), "bcd_%s_into(dst, %s, %s)", names[op], t->a, t->b);
+        expect_true(into[op](dst, a, b), what);
+        expect_free(dst, expected[op], true, what);
+
+        dst = bitset_copy(a);
+        snprintf(what, sizeof(what), "bcd_%s_into(a, a, %s) with a = %s", names[op], t->b, t->a);
+        expect_true(into[op](dst, dst, b), what);
+        expect_free(dst, expected[op], true, what);
+
+        dst = bitset_copy(b);
+        snprintf(what, sizeof(what), "bcd_%s_into(b, %s, b) with b = %s", names[op], t->a, t->b);
+        expect_true(into[op](dst, a, dst), what);
+        expect_free(dst, expected[op], true, what);
+
+        dst = bitset_copy(a);
+        snprintf(what, sizeof(what), "bcd_%s_assign(%s, %s)", names[op], t->a, t->b);
+        expect_true(assign[op](dst, b), what);
+        expect_free(dst, expected[op], true, what);
+
+        // acc op= acc against the fresh-result form
+        Bitset *self = fresh[op](a, a);
+        char *self_expected = self ? to_string(self) : NULL;
+        dst = bitset_copy(a);
+        snprintf(what, sizeof(what), "bcd_%s_assign(acc, acc) with acc = %s", names[op], t->a);
+        expect_true(self_expected && assign[op](dst, dst), what);
+        expect_free(dst, self_expected ? self_expected : "", true, what);
+        free(self_expected);
+        bitset_free(self);
+    }
+
+    Bitset *acc = bitset_copy(a);
+    snprintf(what, sizeof(what), "bcd_fma(acc, %s, %s) with acc = a", t->a, t->b);
+    expect_true(bcd_fma(acc, a, b), what);
+    expect_free(acc, t->a_fma, true, what);
+
+    acc = bitset_copy(a);
+    snprintf(what, sizeof(what), "bcd_fma(a, a, %s) with a = %s", t->b, t->a);
+    expect_true(bcd_fma(acc, acc, b), what);
+    expect_free(acc, t->a_fma, true, what);
+
+    acc = bitset_copy(b);
+    snprintf(what, sizeof(what), "bcd_fma(b, %s, b) with b = %s", t->a, t->b);
+    expect_true(bcd_fma(acc, a, acc), what);
+    expect_free(acc, t->b_fma, true, what);
+
+    const Bitset *pair[] = {a, b};
+    snprintf(what, sizeof(what), "bcd_sum({%s, %s})", t->a, t->b);
+    expect_free(bcd_sum(pair, 2), t->sum, true, what);
+
+    bitset_free(a);
+    bitset_free(b);
+}
+
+static void test_signed(void)
+{
+    for (size_t i = 0; i < sizeof(signed_cases) / sizeof(signed_cases[0]); i++) test_signed_case(&signed_cases[i]);
+
+    Bitset *acc = bitset_from_string("-123");
+    expect_true(bcd_mul_digit_assign(acc, 9), "bcd_mul_digit_assign(-123, 9)");
+    expect(acc, "-1107", true, "bcd_mul_digit_assign(-123, 9)");
+    expect_true(bcd_mul_digit_assign(acc, 0), "bcd_mul_digit_assign(-1107, 0)");
+    expect_free(acc, "0", true, "bcd_mul_digit_assign(-1107, 0)");
+
+    expect_free(bcd_sum(NULL, 0), "0", true, "bcd_sum of nothing");
+
+    // 1000 * (10^40 - 1) - 1000 * (10^39 - 1), then 8000 values, past the counter normalization
+    enum { COLUMN = 8000 };
+    static const Bitset *column[COLUMN];
+    Bitset *big = bitset_from_string(repeat('9', 40)), *small = bitset_from_string(repeat('9', 39));
+    small->is_negative = true;
+    for (size_t i = 0; i < 2000; i++) column[i] = (i & 1) ? small : big;
+    char *expected = keep((char *)malloc(44));
+    memset(expected, '0', 43);
+    expected[0] = '9';
+    expected[43] = '\0';
+    expect_free(bcd_sum(column, 2000), expected, true, "bcd_sum of 10^40 - 1 and -(10^39 - 1), 1000 each");
+
+    Bitset *nines = bitset_from_string(repeat('9', 20));
+    for (size_t i = 0; i < COLUMN; i++) column[i] = nines;
+    expect_free(bcd_sum(column, COLUMN), "799999999999999999992000", true, "bcd_sum of 8000 * (10^20 - 1)");
+    bitset_free(big);
+    bitset_free(small);
+    bitset_free(nines);
+}
+
+int main(void)
+{
+    test_tiers();
+    test_division();
+    test_conversion();
+    test_signed();
+    for (size_t i = 0; i < string_count; i++) free(strings[i]);
+    bcd_pool_trim();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All libbcd checks passed (kernels: %s)\n", bcd_selected_kernels());
+    return 0;
+}